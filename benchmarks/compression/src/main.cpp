@@ -0,0 +1,91 @@
+//
+// Compression benchmark
+//
+// Measures the cycles needed to unpack the packed sprite data
+// against a plain copy of the unpacked data, and reports the
+// decompression throughput in bytes per PAL frame.
+// CIA2 timer A is used as cycle counter, interrupts are disabled.
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <string.h>
+
+#include <sys>
+using namespace sys;
+
+extern const uint8_t sprites_packed[];
+extern const size_t sprites_packed_size;
+
+const uint32_t frame_cycles = 19656; // PAL: 312 lines * 63 cycles
+
+uint8_t buffer[1024];
+
+static inline void startTimer() {
+    memory(0xdd0e) = 0x00;      // stop timer A
+    memory(0xdd04) = 0xff;
+    memory(0xdd05) = 0xff;
+    memory(0xdd0e) = 0x11;      // force load, start continuous
+}
+
+static inline uint16_t stopTimer() {
+    memory(0xdd0e) = 0x00;
+    uint16_t value = memory(0xdd04) | (memory(0xdd05) << 8);
+    return (uint16_t) (0xffff - value);
+}
+
+static uint16_t bytesPerFrame(uint16_t size, uint16_t cycles) {
+    if (0 == cycles) return 0;
+    return (uint16_t) ((uint32_t) size * frame_cycles / cycles);
+}
+
+int main() {
+    System::init();
+    Video::init();
+    Video::clear();
+
+    Video::puts(1, 1, "COMPRESSION BENCHMARK");
+
+    uint16_t size = Compression::getUnpackedSize(sprites_packed);
+    if (size > sizeof(buffer)) {
+        Video::puts(1, 3, "BUFFER TOO SMALL");
+        for (;;) {}
+    }
+
+    System::disableInterrupts();
+
+    startTimer();
+    uint16_t base = stopTimer();
+
+    startTimer();
+    memcpy(buffer, sprites, size);
+    uint16_t copy_cycles = stopTimer() - base;
+
+    startTimer();
+    Compression::unpack(sprites_packed, buffer);
+    uint16_t unpack_cycles = stopTimer() - base;
+
+    System::enableInterrupts();
+
+    bool valid = (0 == memcmp(buffer, sprites, size));
+
+    Video::puts(1, 3, "UNPACKED");
+    Video::printNumber(16, 3, size);
+    Video::puts(1, 4, "PACKED");
+    Video::printNumber(16, 4, (uint16_t) sprites_packed_size);
+
+    Video::puts(12, 6, "CYCLES");
+    Video::puts(22, 6, "BYTES/FRAME");
+    Video::puts(1, 7, "COPY");
+    Video::printNumber(12, 7, copy_cycles);
+    Video::printNumber(22, 7, bytesPerFrame(size, copy_cycles));
+    Video::puts(1, 8, "UNPACK");
+    Video::printNumber(12, 8, unpack_cycles);
+    Video::printNumber(22, 8, bytesPerFrame(size, unpack_cycles));
+
+    Video::puts(1, 10, valid ? "DATA OK" : "DATA MISMATCH");
+
+    for (;;) {}
+
+    return 0;
+}
@@ -0,0 +1,99 @@
+//
+// Math benchmark
+//
+// Measures the cycles per operation of the table based libcpp64
+// math routines against the compiler's built-in runtime routines.
+// CIA2 timer A is used as cycle counter, interrupts are disabled and
+// the screen is blanked, so no badline DMA steals cycles.
+//
+
+#include <cstddef>
+#include <cstdint>
+
+#include <sys>
+using namespace sys;
+
+const uint8_t iterations = 32; // keep timer from wrapping
+
+volatile uint8_t in8a{173};
+volatile uint8_t in8b{91};
+volatile uint16_t in16a{43210};
+volatile uint16_t in16b{1234};
+volatile uint32_t out32{0};
+
+static inline void startTimer() {
+    memory(0xdd0e) = 0x00;      // stop timer A
+    memory(0xdd04) = 0xff;
+    memory(0xdd05) = 0xff;
+    memory(0xdd0e) = 0x11;      // force load, start continuous
+}
+
+static inline uint16_t stopTimer() {
+    memory(0xdd0e) = 0x00;
+    uint16_t value = memory(0xdd04) | (memory(0xdd05) << 8);
+    return (uint16_t) (0xffff - value) / iterations;
+}
+
+static void blankScreen() {
+    // badlines stop once raster line $30 passed with the display disabled
+    memory(0xd011) &= 0xef;
+    while (Video::getRasterLine() < 0x100) {}
+    uint16_t line;
+    do { line = Video::getRasterLine(); } while (line >= 0x100 || line <= 0x30);
+}
+
+static void unblankScreen() {
+    memory(0xd011) |= 0x10;
+}
+
+template <class F>
+static uint16_t measure(F fn) {
+    startTimer();
+    for (uint8_t i=0; i<iterations; i++) fn();
+    return stopTimer();
+}
+
+static void report(uint8_t row, const char* name, uint16_t builtin, uint16_t table) {
+    Video::puts(1, row, name);
+    Video::printNumber(12, row, builtin);
+    Video::printNumber(22, row, table);
+}
+
+int main() {
+    System::init();
+    Video::init();
+    Video::clear();
+
+    Video::puts(1, 1, "MATH BENCHMARK (CYCLES/OP)");
+    Video::puts(12, 3, "BUILTIN");
+    Video::puts(22, 3, "TABLE");
+
+    System::disableInterrupts();
+    blankScreen();
+
+    uint16_t base = measure([]() {});
+
+    uint16_t mul8_builtin = measure([]() { out32 = (uint16_t) in8a * in8b; }) - base;
+    uint16_t mul8_table = measure([]() { out32 = Math::mul8x8(in8a, in8b); }) - base;
+
+    uint16_t mul16_builtin = measure([]() { out32 = (uint32_t) in16a * in16b; }) - base;
+    uint16_t mul16_table = measure([]() { out32 = Math::mul16x16(in16a, in16b); }) - base;
+
+    uint16_t div_builtin = measure([]() { out32 = in16a / in8b; }) - base;
+    uint16_t div_table = measure([]() { out32 = Math::div16x8(in16a, in8b); }) - base;
+
+    uint16_t div10_builtin = measure([]() { out32 = in8a / 10; }) - base;
+    uint16_t div10_table = measure([]() { out32 = Math::div10(in8a); }) - base;
+
+    unblankScreen();
+    System::enableInterrupts();
+
+    report(5, "MUL 8X8", mul8_builtin, mul8_table);
+    report(6, "MUL 16X16", mul16_builtin, mul16_table);
+    report(7, "DIV 16/8", div_builtin, div_table);
+    report(8, "DIV 8/10", div10_builtin, div10_table);
+
+    for (;;) {}
+
+    return 0;
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "./system.h"
+#include "./queue.h"
 
 #include <cstdint>
 #include <string.h>
@@ -8,9 +9,61 @@
 namespace sys {
 
 class Audio {
+    public:
+        struct stats_t {
+            uint8_t update_lines{0};        // raster lines spent in last update
+            uint8_t update_lines_max{0};    // maximum raster lines spent in update
+        };
+
+        static const uint8_t NoVoiceChange = 0xff;
+
+        struct effect_request_t {
+            const uint8_t* stream{nullptr};
+            uint8_t priority{0};
+            uint8_t voice_ofs{NoVoiceChange};   // set by setEffectVoice
+        };
+
+        using EffectQueue = Queue<effect_request_t, 4>;
+
     public:
         static void init();
         static void update();
+
+    public: // sound effects
+        static inline void setEffectsEnabled(bool enabled) noexcept { effects_enabled = enabled; }
+        static void setEffectVoice(uint8_t voice) noexcept;
+        static bool playEffect(const uint8_t* effect, uint8_t priority=0) noexcept;
+        static void stopEffect() noexcept;
+        [[nodiscard]] static inline bool isEffectPlaying() noexcept { return effect_stream != nullptr; }
+        [[nodiscard]] static inline const stats_t& stats() noexcept { return stats_; }
+
+    public: // sound effect command stream
+        static const uint8_t FX_END = 0x00;     // end of effect, voice is given back to the music
+        static const uint8_t FX_WAIT = 0x01;    // n: wait n frames
+        static const uint8_t FX_FREQ = 0x02;    // lo, hi: set frequency
+        static const uint8_t FX_PULSE = 0x03;   // lo, hi: set pulse width
+        static const uint8_t FX_ADSR = 0x04;    // ad, sr: set envelope
+        static const uint8_t FX_CTRL = 0x05;    // ctrl: set waveform and gate
+        static const uint8_t FX_SLIDE = 0x06;   // lo, hi: signed frequency delta added every frame
+
+        static const uint8_t MaxEffectCommands = 8; // max. commands executed per frame
+
+    private:
+        static void flushShadowRegisters() noexcept;
+        static void updateEffect() noexcept;
+        static void endEffect() noexcept;
+        static void startEffects() noexcept;
+
+    private:
+        static stats_t stats_;
+        static bool effects_enabled;
+        static const uint8_t* effect_stream;
+        static uint8_t effect_regs[7];
+        static int16_t effect_slide;
+        static uint8_t effect_wait;
+        static uint8_t effect_priority;
+        static uint8_t effect_voice_ofs;
+        static EffectQueue effect_requests;
 };
 
 }  // namespace sys
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+
+namespace sys {
+
+//
+// LZ4 block decompression.
+//
+// Packed data format (tools/pack64):
+//   2 bytes    unpacked size (little endian)
+//   n bytes    LZ4 block
+//
+// Decompression runs forward, overlapping matches are supported. For
+// in-place decompression, place the packed data at the end of the
+// destination buffer plus the safety margin reported by pack64.
+//
+class Compression {
+    public:
+        [[nodiscard]] static inline uint16_t getUnpackedSize(const uint8_t* src) noexcept {
+            return (uint16_t) (src[0] | (src[1] << 8));
+        }
+
+        static uint8_t* unpack(const uint8_t* src, uint8_t* dest) noexcept;
+};
+
+//
+// Byte-wise LZ4 decompression, for data arriving in pieces (e.g. from disk).
+// Same packed data format as Compression::unpack. Matches are copied from
+// the already unpacked output, so no input buffering is needed.
+//
+class StreamUnpacker {
+    public:
+        void begin(uint8_t* dest) noexcept;
+        [[nodiscard]] bool put(uint8_t value) noexcept;     // false when done
+        [[nodiscard]] inline bool done() const noexcept { return State::Done == state_; }
+        [[nodiscard]] inline uint8_t* getDest() const noexcept { return dest_; }
+
+    private:
+        enum class State : uint8_t {
+            Size0, Size1, Token, LiteralLength, Literals, Offset0, Offset1, MatchLength, Done
+        };
+
+    private:
+        void endLiterals() noexcept;
+        void copyMatch() noexcept;
+
+    private:
+        uint8_t* dest_{nullptr};
+        uint8_t* end_{nullptr};
+        uint16_t length_{0};
+        uint16_t offset_{0};
+        uint8_t token_{0};
+        State state_{State::Done};
+};
+
+}  // namespace sys
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "./system.h"
+
+#include <cstdint>
+
+namespace sys {
+
+//
+// Drive-side code execution (1541 and compatibles).
+//
+// Routines are uploaded into drive RAM with memory-write commands and
+// started with memory-execute, they run on the drive CPU while the C64
+// continues. Results are read back from drive RAM with memory-read.
+// All transfers go through the command channel using the Kernal serial
+// routines. Don't use while the Loader is reading a file.
+//
+// Drive RAM: $0300-$07ff are the DOS buffers 0-4, buffer 2 ($0500) and
+// buffer 3 ($0600) are free for custom code and data while no files
+// are open.
+//
+class Drive {
+    public:
+        static void init(uint8_t device=8) noexcept;
+        [[nodiscard]] static bool upload(uint16_t drive_address, const uint8_t* data, uint16_t size) noexcept;
+        [[nodiscard]] static bool execute(uint16_t drive_address) noexcept;
+        [[nodiscard]] static bool read(uint16_t drive_address, uint8_t* dest, uint8_t size) noexcept;
+
+    public: // built-in drive routines
+        [[nodiscard]] static bool sectorChecksum(uint8_t track, uint8_t sector, uint8_t& checksum) noexcept;
+
+    public:
+        static const uint16_t CodeAddress = 0x0500;     // buffer 2
+        static const uint16_t DataAddress = 0x0600;     // buffer 3
+        static const uint8_t MaxWriteSize = 32;         // data bytes per memory-write command
+
+    private:
+        static bool open() noexcept;
+        static void close() noexcept;
+        static bool sendCommand(const uint8_t* command, uint8_t size) noexcept;
+        static bool memoryWrite(uint16_t drive_address, const uint8_t* data, uint8_t size) noexcept;
+
+    private:
+        static uint8_t device;
+        static bool checksum_uploaded;
+};
+
+}  // namespace sys
@@ -0,0 +1,102 @@
+#pragma once
+
+//
+// Host backend (LIBCPP64_HOST)
+//
+// Builds libcpp64 natively (see CMakeLists.txt) against a simulated 64K
+// address space. sys::memory() goes through per-page read/write hooks,
+// pages without hooks are plain RAM. Pointers into C64 memory are
+// translated with sys::to_ptr()/sys::to_address().
+//
+// Default hooks:
+//   $d000-$d3ff  VIC: raster counter, raster compare and irq flags
+//   $d400-$d7ff  SID: write-only registers, last values in getSidRegister()
+//   $dc00-$dcff  CIA1: keyboard matrix and joysticks
+//   $de00-$dfff  expansion port: open bus (no REU)
+//
+// The hooks are installed on the first memory access. Tests call
+// reset() to start from a clean machine.
+//
+// The raster counter advances by one line on each read of $d011/$d012,
+// so polling loops terminate. Reaching the raster compare line with the
+// raster irq enabled calls the installed interrupt handler.
+//
+
+#include <cstdint>
+
+namespace sys {
+
+typedef void (*interrupt_handler_t)(void);
+
+class Host {
+
+    public:
+        typedef uint8_t (*read_hook_t)(uint16_t address);
+        typedef void (*write_hook_t)(uint16_t address, uint8_t value);
+
+        class Register {
+            public:
+                explicit Register(uint16_t address) noexcept : address_(address) {}
+                operator uint8_t() const noexcept { return read(address_); }
+                Register& operator=(uint8_t value) noexcept { write(address_, value); return *this; }
+                Register& operator=(const Register& other) noexcept { return *this = (uint8_t) other; }
+                Register& operator|=(uint8_t value) noexcept { return *this = (uint8_t) (read(address_) | value); }
+                Register& operator&=(uint8_t value) noexcept { return *this = (uint8_t) (read(address_) & value); }
+
+            private:
+                uint16_t address_;
+        };
+
+    public:
+        static void reset() noexcept;
+        static void setReadHook(uint8_t page, read_hook_t hook) noexcept;
+        static void setWriteHook(uint8_t page, write_hook_t hook) noexcept;
+        [[nodiscard]] static uint8_t read(uint16_t address) noexcept;
+        static void write(uint16_t address, uint8_t value) noexcept;
+
+    public: // vic
+        static void advanceRaster(uint16_t lines) noexcept;
+        static void runFrame() noexcept { advanceRaster(raster_lines); }
+        [[nodiscard]] static uint16_t getRasterLine() noexcept { return raster_line; }
+        static void setRasterLines(uint16_t lines) noexcept { raster_lines = lines; }
+
+    public: // sid
+        [[nodiscard]] static uint8_t getSidRegister(uint8_t reg) noexcept { return ram[0xd400 + (reg & 0x1f)]; }
+
+    public: // cia1
+        static void setKey(uint8_t keycode, bool pressed) noexcept;
+        static void setJoystick(uint8_t port, uint8_t bits) noexcept { joystick[port & 1] = bits & 0x1f; }
+
+    public: // interrupts
+        static void setInterruptHandler(interrupt_handler_t fn) noexcept { interrupt_handler = fn; }
+        static void setInterruptsEnabled(bool enabled) noexcept { interrupts_enabled = enabled; }
+        static void raiseInterrupt() noexcept;
+
+    public:
+        static const uint16_t ProgramEnd = 0x0801;      // no program image in the simulated ram
+        static uint8_t ram[0x10000];
+
+    private:
+        static void init() noexcept;
+        static uint8_t readVic(uint16_t address) noexcept;
+        static void writeVic(uint16_t address, uint8_t value) noexcept;
+        static uint8_t readSid(uint16_t address) noexcept;
+        static void writeSid(uint16_t address, uint8_t value) noexcept;
+        static uint8_t readCia1(uint16_t address) noexcept;
+        static uint8_t readOpenBus(uint16_t address) noexcept;
+
+    private:
+        static read_hook_t read_hooks[256];
+        static write_hook_t write_hooks[256];
+        static uint16_t raster_line;
+        static uint16_t raster_compare;
+        static uint16_t raster_lines;
+        static uint8_t key_matrix[8];                   // bit set = pressed
+        static uint8_t joystick[2];                     // bit set = active
+        static interrupt_handler_t interrupt_handler;
+        static bool interrupts_enabled;
+        static bool in_interrupt;
+        static bool initialized;
+};
+
+}  // namespace sys
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "./system.h"
+#include "./queue.h"
 
 #include <cstdint>
 #include <string.h>
@@ -14,6 +15,12 @@ class Keyboard {
         [[nodiscard]] static bool getBufferedKeyState(uint8_t keycode) noexcept;
         [[nodiscard]] static bool getKeyState(uint8_t keycode) noexcept;
 
+    public: // irq driven input scanning
+        static void scan() noexcept;
+        [[nodiscard]] static bool pollEvent(uint8_t& event) noexcept;
+        [[nodiscard]] static bool isKeyDown(uint8_t keycode) noexcept;
+        [[nodiscard]] static inline uint8_t getJoystick(uint8_t port) noexcept { return joystick_state[(port - 1) & 0x1]; }
+
     public:
         // CIA1 PA|PB
         static const uint8_t KEY_CURSOR_DOWN = 0x07;
@@ -25,8 +32,31 @@ class Keyboard {
         static const uint8_t KEY_A = 0x12;
         static const uint8_t KEY_B = 0x43;
 
+    public:
+        // event = keycode | EVENT_KEY_UP
+        static const uint8_t EVENT_KEY_UP = 0x80;
+        static const uint8_t EventQueueSize = 16; // power of two
+        using EventQueue = Queue<uint8_t, EventQueueSize>;
+
+    public:
+        // joystick bits (1 = active)
+        static const uint8_t JOY_UP = 0x01;
+        static const uint8_t JOY_DOWN = 0x02;
+        static const uint8_t JOY_LEFT = 0x04;
+        static const uint8_t JOY_RIGHT = 0x08;
+        static const uint8_t JOY_FIRE = 0x10;
+
+    private:
+        static uint8_t getGhostRows() noexcept;
+        static void pushEdges(uint8_t row, uint8_t changed, uint8_t state) noexcept;
+
     private:
-        static uint8_t keyboard_buffer[8];
+        LIBCPP64_ZEROPAGE_DATA static uint8_t keyboard_buffer[8];
+        static uint8_t keyboard_state[8];   // debounced, 1 = pressed
+        static uint8_t keyboard_last[8];    // last raw scan, 1 = pressed
+        static bool keyboard_active;
+        static uint8_t joystick_state[2];
+        static EventQueue events;
 
 };
 
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "./system.h"
+#include "./queue.h"
+#include "./compression.h"
+
+#include <cstdint>
+
+namespace sys {
+
+//
+// Streaming file loader.
+//
+// Files are loaded by name from a disk drive using the Kernal serial
+// routines, in chunks of ChunkSize bytes per update() call. Call update()
+// from the main loop, it returns quickly when idle. The Kernal ROM is
+// only mapped in while talking to the drive, raster interrupts keep
+// running during the transfer.
+//
+// Files are PRG files (see tools/disk64), the load address is skipped and
+// the data is written to the given destination. With FLAG_UNPACK, the
+// file holds pack64 packed data and is unpacked on the fly.
+//
+class Loader {
+    public:
+        typedef void (*callback_t)(uint8_t status, uint8_t* end);
+
+        struct request_t {
+            const char* name{nullptr};
+            uint8_t* dest{nullptr};
+            callback_t callback{nullptr};
+            uint8_t flags{0};
+        };
+
+        using RequestQueue = Queue<request_t, 4>;
+
+    public:
+        static void init(uint8_t device=8) noexcept;
+        [[nodiscard]] static bool load(const char* name, uint8_t* dest, callback_t callback=nullptr, uint8_t flags=0) noexcept;
+        static void update() noexcept;
+        [[nodiscard]] static inline bool isBusy() noexcept { return State::Idle != state || !requests.empty(); }
+
+    public:
+        static const uint8_t FLAG_UNPACK = 0x01;
+
+        static const uint8_t STATUS_OK = 0x00;
+        static const uint8_t STATUS_OPEN_FAILED = 0x01;   // device not present
+        static const uint8_t STATUS_READ_ERROR = 0x02;    // file not found, read error
+
+        // bytes per update. the kernal serial routines move about 400 bytes
+        // per second (~2.5ms per byte) and chkin/clrch add a talk/untalk
+        // handshake, so one update stalls the main loop for about half a
+        // frame. 32 bytes would stall it for four frames.
+        static const uint8_t ChunkSize = 4;
+
+    private:
+        enum class State : uint8_t {
+            Idle, Data
+        };
+
+    private:
+        static bool open() noexcept;
+        static uint8_t readChunk() noexcept;
+        static void close() noexcept;
+        static void finish(uint8_t status) noexcept;
+
+    private:
+        static RequestQueue requests;
+        static request_t current;
+        static State state;
+        static uint8_t device;
+        static uint8_t* dest;
+        static uint8_t read_status;
+        static uint8_t chunk[ChunkSize];
+        static StreamUnpacker unpacker;
+};
+
+}  // namespace sys
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+
+namespace sys {
+
+class Math {
+    public: // table based multiplication (quarter squares)
+        [[nodiscard]] static uint16_t mul8x8(uint8_t a, uint8_t b) noexcept;
+        [[nodiscard]] static int16_t mul8x8s(int8_t a, int8_t b) noexcept;
+        [[nodiscard]] static uint32_t mul16x16(uint16_t a, uint16_t b) noexcept;
+        [[nodiscard]] static int32_t mul16x16s(int16_t a, int16_t b) noexcept;
+
+    public: // table based division (reciprocals)
+        [[nodiscard]] static uint16_t div16x8(uint16_t a, uint8_t b) noexcept;
+        [[nodiscard]] static inline uint8_t div10(uint8_t a) noexcept { return (uint8_t) (mul8x8(a, 205) >> 11); }
+
+    public: // trigonometry, angle 0..255 is a full circle, results scaled by 127
+        [[nodiscard]] static int8_t sin(uint8_t angle) noexcept;
+        [[nodiscard]] static int8_t cos(uint8_t angle) noexcept;
+        [[nodiscard]] static uint8_t atan2(int16_t y, int16_t x) noexcept;
+};
+
+//
+// Fixed point number with F fractional bits, stored as signed 16 bit.
+//
+template <uint8_t F>
+class Fixed {
+    public:
+        constexpr Fixed() = default;
+        static constexpr Fixed fromRaw(int16_t raw) noexcept { Fixed f; f.value = raw; return f; }
+        static constexpr Fixed fromInt(int16_t i) noexcept { return fromRaw((int16_t) (i << F)); }
+
+    public:
+        [[nodiscard]] constexpr int16_t raw() const noexcept { return value; }
+        [[nodiscard]] constexpr int16_t toInt() const noexcept { return (int16_t) (value >> F); }
+        [[nodiscard]] constexpr uint8_t frac() const noexcept { return (uint8_t) ((value & ((1 << F) - 1)) << (8 - F)); }
+
+    public:
+        constexpr Fixed operator+(Fixed other) const noexcept { return fromRaw(value + other.value); }
+        constexpr Fixed operator-(Fixed other) const noexcept { return fromRaw(value - other.value); }
+        constexpr Fixed operator-() const noexcept { return fromRaw(-value); }
+        constexpr Fixed& operator+=(Fixed other) noexcept { value += other.value; return *this; }
+        constexpr Fixed& operator-=(Fixed other) noexcept { value -= other.value; return *this; }
+        constexpr bool operator==(Fixed other) const noexcept { return value == other.value; }
+        constexpr bool operator<(Fixed other) const noexcept { return value < other.value; }
+        constexpr bool operator>(Fixed other) const noexcept { return value > other.value; }
+
+        Fixed operator*(Fixed other) const noexcept {
+            return fromRaw((int16_t) (Math::mul16x16s(value, other.value) >> F));
+        }
+
+        // scale by sin/cos style factor (-127..127 = -1..1)
+        [[nodiscard]] Fixed scale(int8_t factor) const noexcept {
+            return fromRaw((int16_t) ((Math::mul16x16s(value, factor) + 64) >> 7));
+        }
+
+    private:
+        int16_t value{0};
+};
+
+using fix8_8 = Fixed<8>;
+using fix12_4 = Fixed<4>;
+
+}  // namespace sys
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+
+namespace sys {
+
+//
+// Self-modifying code patch points.
+//
+// A patch point is a global label on the operand of an instruction, e.g.
+// the immediate of 'lda #nn' or the address of 'sta $nnnn'. Patching the
+// operand from C++ turns indexed loads and pointer accesses in hot code
+// into 2-cycle immediates and 4-cycle absolute accesses.
+//
+// Inline asm, in a noinline function (the label must exist only once):
+//
+//   asm volatile(
+//       LIBCPP64_PATCH_POINT(border_color) "lda #0\n"
+//       "sta $d020\n"
+//       ::: "a", "memory");
+//
+// Assembler sources (see src/raster.asm):
+//
+//   .global border_color
+//   border_color = . + 1
+//   lda #0
+//
+// C++:
+//
+//   LIBCPP64_DECLARE_PATCH(border_color);
+//   Patch::set8(border_color, 2);
+//
+// 16-bit operands are written in two steps. If the patched code runs in
+// an interrupt handler, disable interrupts around set16.
+//
+
+#define LIBCPP64_PATCH_POINT(name) ".global " #name "\n" #name " = . + 1\n"
+#define LIBCPP64_DECLARE_PATCH(name) extern "C" volatile uint8_t name[2]
+
+class Patch {
+    public:
+        static inline void set8(volatile uint8_t* operand, uint8_t value) noexcept {
+            operand[0] = value;
+        }
+
+        static inline void set16(volatile uint8_t* operand, uint16_t value) noexcept {
+            operand[0] = (uint8_t) (value & 0xff);
+            operand[1] = (uint8_t) (value >> 8);
+        }
+
+        [[nodiscard]] static inline uint8_t get8(const volatile uint8_t* operand) noexcept {
+            return operand[0];
+        }
+
+        [[nodiscard]] static inline uint16_t get16(const volatile uint8_t* operand) noexcept {
+            return (uint16_t) (operand[0] | (operand[1] << 8));
+        }
+};
+
+}  // namespace sys
@@ -0,0 +1,96 @@
+#pragma once
+
+//
+// Placement of hot variables and lookup tables.
+//
+
+//
+// Zero page
+//
+// The linker script reserves the zero page region right after the
+// LLVM-MOS imaginary registers ($22-$8f), below the zero page used by the
+// SID player. The compiler recognizes the .zp sections and uses 3-cycle
+// zero page addressing for these variables, pointers stored there can
+// be used with (zp),Y addressing. Zero page usage is reported by the
+// linker (--print-memory-usage).
+//
+// Usage: annotate both the declaration and the definition.
+//
+//   LIBCPP64_ZEROPAGE uint8_t counter;            // zero initialized
+//   LIBCPP64_ZEROPAGE_DATA uint8_t mask{0xff};    // initialized
+//
+
+#define LIBCPP64_ZEROPAGE __attribute__((section(".zp.bss")))
+#define LIBCPP64_ZEROPAGE_DATA __attribute__((section(".zp.data")))
+
+//
+// Page alignment
+//
+// Indexed reads (abs,X / abs,Y) that cross a page boundary cost an extra
+// cycle. Tables of 256 bytes should be page aligned. Smaller tables read
+// in hot loops go to the hot table section, which the linker script page
+// aligns and checks to fit into a single page, so no table in it
+// straddles a page boundary.
+//
+// Usage: annotate the definition.
+//
+//   LIBCPP64_PAGE_ALIGNED const uint8_t table[256]{...};
+//   LIBCPP64_HOT_TABLE uint16_t offsets[25];
+//   LIBCPP64_HOT_CONST_TABLE const uint8_t colors[8]{...};
+//
+
+#define LIBCPP64_PAGE_ALIGNED __attribute__((aligned(256)))
+#define LIBCPP64_HOT_TABLE __attribute__((section(".hot_tables.data")))
+#define LIBCPP64_HOT_CONST_TABLE __attribute__((section(".hot_tables.rodata")))
+
+//
+// Overlays under I/O and ROM
+//
+// The linker script places the overlay sections at $d000-$dfff (RAM under
+// I/O) and $e000-$fff9 (RAM under the Kernal ROM). Their contents are
+// stored within the program and copied to the overlay area by
+// System::init, the load area is given back to the memory allocator.
+//
+// Requires the Kernal and BASIC ROMs to be disabled (see
+// System::disableKernalAndBasic). ROM overlays are then directly usable,
+// I/O overlays are only visible with I/O banked out. Call I/O overlay
+// functions through System::callBanked(System::MEMMAP_RAM, ...), overlay
+// code must not access I/O registers.
+//
+// Usage: annotate the definition.
+//
+//   LIBCPP64_OVERLAY_IO void updateTables() { ... }
+//   LIBCPP64_OVERLAY_IO_DATA uint8_t buffer[2048];
+//   LIBCPP64_OVERLAY_ROM const uint8_t level_data[]{...};
+//
+
+#define LIBCPP64_OVERLAY_IO __attribute__((section(".overlay_io.text"), noinline))
+#define LIBCPP64_OVERLAY_IO_DATA __attribute__((section(".overlay_io.data")))
+#define LIBCPP64_OVERLAY_ROM __attribute__((section(".overlay_rom.text"), noinline))
+#define LIBCPP64_OVERLAY_ROM_DATA __attribute__((section(".overlay_rom.data")))
+
+//
+// Host build
+//
+// Native compilers know none of the sections above, variables and
+// functions are placed as usual.
+//
+
+#if defined(LIBCPP64_HOST)
+#undef LIBCPP64_ZEROPAGE
+#undef LIBCPP64_ZEROPAGE_DATA
+#undef LIBCPP64_HOT_TABLE
+#undef LIBCPP64_HOT_CONST_TABLE
+#undef LIBCPP64_OVERLAY_IO
+#undef LIBCPP64_OVERLAY_IO_DATA
+#undef LIBCPP64_OVERLAY_ROM
+#undef LIBCPP64_OVERLAY_ROM_DATA
+#define LIBCPP64_ZEROPAGE
+#define LIBCPP64_ZEROPAGE_DATA
+#define LIBCPP64_HOT_TABLE
+#define LIBCPP64_HOT_CONST_TABLE
+#define LIBCPP64_OVERLAY_IO __attribute__((noinline))
+#define LIBCPP64_OVERLAY_IO_DATA
+#define LIBCPP64_OVERLAY_ROM __attribute__((noinline))
+#define LIBCPP64_OVERLAY_ROM_DATA
+#endif
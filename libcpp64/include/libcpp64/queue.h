@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+
+namespace sys {
+
+//
+// Lock-free single-producer/single-consumer ring buffer.
+//
+// Safe to pass data between interrupt (IRQ/NMI) and main context without
+// disabling interrupts, as long as each queue has exactly one producer
+// context and one consumer context:
+// - head is only written by the producer, tail only by the consumer
+// - indices are single bytes, so reads and writes are atomic on the 6502
+// - the element is written before head is published (compiler barrier)
+//
+// One slot is kept free to tell full from empty, so N-1 elements fit.
+//
+template <class T, uint8_t N>
+class Queue {
+    static_assert(N >= 2 && N <= 128 && (N & (N - 1)) == 0, "queue capacity must be a power of two");
+
+    public:
+        [[nodiscard]] inline bool push(const T& value) noexcept {   // producer only
+            uint8_t head = head_;
+            uint8_t next_head = (head + 1) & (N - 1);
+            if (next_head == tail_) return false;                   // full
+            buffer_[head] = value;
+            asm volatile("" ::: "memory");                          // element before head
+            head_ = next_head;
+            return true;
+        }
+
+        [[nodiscard]] inline bool pop(T& value) noexcept {          // consumer only
+            uint8_t tail = tail_;
+            if (tail == head_) return false;                        // empty
+            asm volatile("" ::: "memory");                          // head before element
+            value = buffer_[tail];
+            asm volatile("" ::: "memory");                          // element before tail
+            tail_ = (tail + 1) & (N - 1);
+            return true;
+        }
+
+        inline void clear() noexcept { tail_ = head_; }            // consumer only
+
+        [[nodiscard]] inline bool empty() const noexcept { return head_ == tail_; }
+        [[nodiscard]] inline bool full() const noexcept { return ((head_ + 1) & (N - 1)) == tail_; }
+        [[nodiscard]] inline uint8_t size() const noexcept { return (head_ - tail_) & (N - 1); }
+        [[nodiscard]] static constexpr uint8_t capacity() noexcept { return N - 1; }
+
+    private:
+        T buffer_[N];
+        volatile uint8_t head_{0};
+        volatile uint8_t tail_{0};
+};
+
+}  // namespace sys
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "./system.h"
+
+#include <cstdint>
+
+namespace sys {
+
+//
+// RAM Expansion Unit (1700/1750/1764 and compatibles).
+//
+// DMA transfers between C64 memory and expansion memory run at one
+// byte per cycle with the CPU halted. Bank 0 of the expansion memory is
+// used as staging area for C64 to C64 copies and swaps (see
+// System::copy/fill/swap), the banks above hold the asset cache.
+//
+// The REU registers are not saved, so transfers must not be started
+// from interrupt handlers while the main program uses the REU.
+//
+class Reu {
+    public:
+        struct cache_entry_t {
+            uint32_t address{0};
+            uint16_t size{0};
+        };
+
+    public:
+        static void init() noexcept;
+        [[nodiscard]] static inline bool isPresent() noexcept { return 0 != bank_count; }
+        [[nodiscard]] static inline uint16_t getBankCount() noexcept { return bank_count; }
+
+    public: // dma transfers
+        static void stash(const void* src, uint32_t reu_address, uint16_t size) noexcept;
+        static void fetch(void* dest, uint32_t reu_address, uint16_t size) noexcept;
+        static void copy(void* dest, const void* src, uint16_t size) noexcept;
+        static void fill(void* dest, uint8_t value, uint16_t size) noexcept;
+        static void swap(void* a, void* b, uint16_t size) noexcept;
+
+    public: // asset cache
+        [[nodiscard]] static uint8_t cacheStore(const void* src, uint16_t size) noexcept;
+        [[nodiscard]] static bool cacheLoad(uint8_t handle, void* dest) noexcept;
+        [[nodiscard]] static uint16_t cacheSize(uint8_t handle) noexcept;
+        static void cacheClear() noexcept;
+
+    public:
+        static const uint8_t MaxCacheEntries = 16;
+        static const uint8_t InvalidHandle = 0xff;
+        static const uint16_t MinTransferSize = 16;     // smaller transfers are faster with the cpu
+
+    private:
+        static bool detect() noexcept;
+        static uint16_t detectBanks() noexcept;
+        static void transfer(uint8_t command, uint16_t c64_address, uint32_t reu_address, uint16_t size, uint8_t control) noexcept;
+
+    private:
+        static uint16_t bank_count;
+        static uint32_t cache_top;
+        static uint8_t cache_count;
+        static cache_entry_t cache_entries[MaxCacheEntries];
+};
+
+}  // namespace sys
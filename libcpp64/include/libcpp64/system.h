@@ -2,6 +2,13 @@
 
 #include <cstdint>
 #include <string.h>
+#include <type_traits>
+
+#include "./placement.h"
+
+#if defined(LIBCPP64_HOST)
+#include "./host.h"
+#endif
 
 using address_t = volatile uint8_t*;
 
@@ -9,10 +16,25 @@ namespace sys {
 
 typedef void (*interrupt_handler_t)(void);
 
+#if defined(LIBCPP64_HOST)
+Host::Register memory(const uint16_t address);
+#else
 volatile uint8_t& memory(const uint16_t address);
+#endif
 void set_bit(const uint16_t address, uint8_t bit, bool enabled);
 [[nodiscard]] bool get_bit(const uint16_t address, uint8_t bit);
 
+// c64 address <-> pointer, the host build maps addresses to the simulated ram
+#if defined(LIBCPP64_HOST)
+[[nodiscard]] inline uint8_t* to_ptr(const uint16_t address) noexcept { return Host::ram + address; }
+[[nodiscard]] inline uint16_t to_address(const volatile void* ptr) noexcept {
+    return (uint16_t) (reinterpret_cast<const volatile uint8_t*>(ptr) - Host::ram);
+}
+#else
+[[nodiscard]] inline uint8_t* to_ptr(const uint16_t address) noexcept { return reinterpret_cast<uint8_t*>(address); }
+[[nodiscard]] inline uint16_t to_address(const volatile void* ptr) noexcept { return reinterpret_cast<uint16_t>(ptr); }
+#endif
+
 
 class Constants {
     public: // Screen constants
@@ -60,14 +82,82 @@ class System {
         static void enableKernalAndBasic() noexcept;
         static bool isKernalAndBasicDisabled() noexcept { return kernalAndBasicDisabled; }
         static void memMap(uint8_t bits) noexcept;
+        static void beginKernalAccess() noexcept;
+        static void endKernalAccess() noexcept;
+        static void setInterruptHandler(interrupt_handler_t fn) noexcept;
+
+    public: // banked calls (overlays, see placement.h)
+        template <typename R, typename... Args>
+        static inline R callBanked(uint8_t bits, R (*fn)(Args...), Args... args) noexcept {
+            // irqs started in between restore $01 on exit (see setInterruptHandler)
+            uint8_t saved = memory(0x01);
+            memory(0x01) = (saved & 0xf8) | (bits & 0x7);
+            if constexpr (std::is_void_v<R>) {
+                fn(args...);
+                memory(0x01) = saved;
+            } else {
+                R result = fn(args...);
+                memory(0x01) = saved;
+                return result;
+            }
+        }
+
+        static const uint8_t MEMMAP_RAM = 0x4;          // all RAM
+        static const uint8_t MEMMAP_CHAR_ROM = 0x1;     // RAM + character ROM at $d000
+        static const uint8_t MEMMAP_IO = 0x5;           // RAM + I/O at $d000
         static void copyRomCharset(uint8_t* dest, size_t src_offset=0, size_t char_count=0) noexcept;
         static void copyCharset(const uint8_t* src, uint8_t* dest, size_t char_count) noexcept;
 
+    public: // bulk memory operations, use REU dma if present
+        static void copy(void* dest, const void* src, uint16_t size) noexcept;
+        static void fill(void* dest, uint8_t value, uint16_t size) noexcept;
+        static void swap(void* a, void* b, uint16_t size) noexcept;
+
+    public: // memory regions
+        [[nodiscard]] static uint8_t* allocate(uint16_t size, uint16_t align=1) noexcept;
+        [[nodiscard]] static uint8_t* allocateVic(uint16_t size, uint16_t align, uint8_t bank) noexcept;
+        [[nodiscard]] static bool reserveMemory(uint16_t start, uint16_t size) noexcept;
+        [[nodiscard]] static uint16_t getFreeMemory() noexcept;
+
+        static const uint16_t SoftStackSize = 0x400;        // below $d000, grows down
+        static const uint8_t MaxMemoryRanges = 12;
+
+    public: // stack high-water marks
+        struct stack_stats_t {
+            uint16_t hardware_max{0};       // max. bytes used of the hardware stack ($0100-$01ff)
+            uint16_t soft_max{0};           // max. bytes used of the soft stack (SoftStackSize: overflow)
+        };
+
+        static void paintStacks() noexcept;
+        [[nodiscard]] static stack_stats_t stackStats() noexcept;
+
+        static const uint16_t SoftStackTop = 0xd000;        // __stack (link.ld)
+        static const uint8_t StackPaint = 0xa5;
+
     public:
         [[nodiscard]] static constexpr uint8_t get_compiler_standard() noexcept;
 
     public:
         static bool kernalAndBasicDisabled;
+        static bool bankedInterrupts;
+
+    private:
+        struct memory_range_t {
+            uint16_t start{0};
+            uint16_t end{0};            // exclusive
+            bool under_rom{false};      // cpu readable only with roms switched off
+        };
+
+    private:
+        static void initMemory() noexcept;
+        static void initOverlays() noexcept;
+        static void addMemoryRange(uint16_t start, uint16_t end, bool under_rom) noexcept;
+        static uint8_t* allocateRange(uint16_t size, uint16_t align, uint16_t lo, uint16_t hi, bool allow_under_rom, uint16_t avoid) noexcept;
+        static bool carveRange(uint8_t index, uint16_t start, uint16_t end) noexcept;
+
+    private:
+        static memory_range_t memory_ranges[MaxMemoryRanges];
+        static uint8_t memory_range_count;
 };
 
 }  // namespace sys
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdint>
+
+#include "./system.h"
+
+namespace sys {
+
+//
+// Emulator trace channel (LIBCPP64_TRACE).
+//
+// Events are written to unused SID register mirrors at $d7fc-$d7fe, which
+// the SID ignores. The emulator records the writes together with the
+// raster line and cycle, tools/trace64 turns the log into a timeline.
+//
+//   Trace::event(Events::LevelStart);             // sta $d7fe
+//   Trace::event16(Events::Score, score);         // sta $d7fd, sta $d7fc, sta $d7fe
+//
+// The value ports are latched by the next event. Value and event are
+// written with interrupts masked, so an irq tracing in between doesn't
+// overwrite a pending value. Without LIBCPP64_TRACE
+// (add it to "definitions" in project-config.json) all calls compile to
+// nothing. VICE: log the writes with tools/trace64 -c > trace.mon and
+// 'x64sc -moncommands trace.mon -monlog -monlogname trace.log'.
+//
+// Event ids $f0-$ff are used by libcpp64.
+//
+
+class Trace {
+    public:
+        static const uint16_t ValueHiPort = 0xd7fc;
+        static const uint16_t ValueLoPort = 0xd7fd;
+        static const uint16_t EventPort = 0xd7fe;      // not $d7ff, that's the VICE debug cart
+
+        static const uint8_t EventIrqBegin = 0xf0;      // value: raster sequence step
+        static const uint8_t EventIrqEnd = 0xf1;
+        static const uint8_t EventWaitBegin = 0xf2;     // Video::waitNextFrame
+        static const uint8_t EventWaitEnd = 0xf3;
+        static const uint8_t EventLoadBegin = 0xf4;     // Loader: file opened
+        static const uint8_t EventLoadEnd = 0xf5;       // value: status
+
+#if defined(LIBCPP64_TRACE)
+        static const bool Enabled = true;
+#else
+        static const bool Enabled = false;
+#endif
+
+    public:
+        static inline void event(uint8_t id) noexcept {
+            if constexpr (Enabled) write(EventPort, id);
+        }
+
+        static inline void event8(uint8_t id, uint8_t value) noexcept {
+            if constexpr (Enabled) {
+                uint8_t flags = mask();
+                write(ValueLoPort, value);
+                write(EventPort, id);
+                restore(flags);
+            }
+        }
+
+        static inline void event16(uint8_t id, uint16_t value) noexcept {
+            if constexpr (Enabled) {
+                uint8_t flags = mask();
+                write(ValueLoPort, (uint8_t) (value & 0xff));
+                write(ValueHiPort, (uint8_t) (value >> 8));
+                write(EventPort, id);
+                restore(flags);
+            }
+        }
+
+    private:
+        static inline uint8_t mask() noexcept {
+            // returns the processor status, keeps the i flag of an irq handler
+#if defined(LIBCPP64_HOST)
+            return 0;
+#else
+            uint8_t flags;
+            asm volatile("php\npla\nsei" : "=a" (flags) :: "memory");
+            return flags;
+#endif
+        }
+
+        static inline void restore(uint8_t flags) noexcept {
+#if defined(LIBCPP64_HOST)
+            (void) flags;
+#else
+            asm volatile("pha\nplp" :: "a" (flags) : "memory");
+#endif
+        }
+
+        static inline void write(uint16_t port, uint8_t value) noexcept {
+#if defined(LIBCPP64_HOST)
+            Host::write(port, value);
+#else
+            *reinterpret_cast<volatile uint8_t*>(port) = value;
+#endif
+        }
+};
+
+}  // namespace sys
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "./system.h"
+#include "./queue.h"
 
 #include <cstdint>
 #include <string.h>
@@ -34,13 +35,26 @@ class Video {
         };
 
         struct stats_t {
-            uint16_t frame_counter{0};
+            uint16_t frame_counter{0};      // frames elapsed
+            uint16_t frames_processed{0};   // main loop iterations (waitNextFrame calls)
+            uint16_t frames_dropped{0};     // frames the main loop overran (needs the raster irq)
+            uint16_t loop_lines{0};         // raster lines spent in the last main loop iteration
+            uint16_t loop_lines_max{0};     // maximum raster lines spent in a main loop iteration
             uint16_t time_seconds{0};
             uint16_t time_millis{0};
             uint16_t time_delta{0};
             uint16_t time_micro_err{0};
         };
 
+        struct sprite_command_t {
+            uint8_t sprite{0};
+            uint8_t block{0};
+            uint16_t x{0};
+            uint8_t y{0};
+        };
+
+        using SpriteCommandQueue = Queue<sprite_command_t, 16>;
+
     public:
         static void init() noexcept;
         static void setGraphicsMode(GraphicsMode mode) noexcept;
@@ -48,14 +62,18 @@ class Video {
         static void setScreenBase(uint8_t base) noexcept;
         static void setBitmapBase(uint8_t base) noexcept;
         static void setCharacterBase(uint8_t base) noexcept;
-        static volatile uint8_t* getBasePtr() noexcept { return (address_t)(vic_base); };
-        static volatile uint8_t* getScreenBasePtr() noexcept { return (address_t)(screen_base); };
-        static volatile uint8_t* getColorBasePtr() noexcept { return (address_t)(color_base); };
-        static volatile uint8_t* getBitmapBasePtr() noexcept { return (address_t)(bitmap_base); };
-        static volatile uint8_t* getCharacterBasePtr() noexcept { return (address_t)(char_base); };
-        static volatile uint8_t* getCharacterBasePtr(uint8_t base) noexcept { return (address_t)(vic_base + base * 0x800); };
-        static volatile uint8_t* getScreenPtr(uint8_t row) noexcept { return (address_t)(row_addresses[row]); };
-        static volatile uint8_t* getColorPtr(uint8_t row) noexcept { return (address_t)(col_addresses[row]); };
+        [[nodiscard]] static uint8_t allocateScreenBase() noexcept;
+        [[nodiscard]] static uint8_t allocateCharacterBase() noexcept;
+        static bool loadSprites() noexcept;
+        static bool loadSprites(const uint8_t* packed) noexcept;
+        static volatile uint8_t* getBasePtr() noexcept { return to_ptr(vic_base); };
+        static volatile uint8_t* getScreenBasePtr() noexcept { return to_ptr(screen_base); };
+        static volatile uint8_t* getColorBasePtr() noexcept { return to_ptr(color_base); };
+        static volatile uint8_t* getBitmapBasePtr() noexcept { return to_ptr(bitmap_base); };
+        static volatile uint8_t* getCharacterBasePtr() noexcept { return to_ptr(char_base); };
+        static volatile uint8_t* getCharacterBasePtr(uint8_t base) noexcept { return to_ptr(vic_base + base * 0x800); };
+        static volatile uint8_t* getScreenPtr(uint8_t row) noexcept { return to_ptr(row_addresses[row]); };
+        static volatile uint8_t* getColorPtr(uint8_t row) noexcept { return to_ptr(col_addresses[row]); };
 
     public:
         static void setScrollX(uint8_t offset) noexcept;
@@ -71,6 +89,8 @@ class Video {
         static void setSpriteCommonColors(uint8_t colorA, uint8_t colorB) noexcept;
         static uint8_t getSpriteAddress(const uint8_t* data=nullptr) noexcept;
         static void setTextCommonColors(uint8_t colorA, uint8_t colorB) noexcept;
+        [[nodiscard]] static bool postSpriteCommand(const sprite_command_t& command) noexcept;
+        static void processSpriteCommands() noexcept;
 
     public:
         static void enableRasterSequence() noexcept;
@@ -80,7 +100,7 @@ class Video {
         static inline uint8_t getCurrentRasterSequenceStep() noexcept { return raster_sequence_step; }
 
         [[nodiscard]] static inline uint16_t getRasterLine() noexcept {
-            return (memory(0xd011) & 0x80 >> 7) | memory(0xd012);
+            return (uint16_t) (((memory(0xd011) & 0x80) << 1) | memory(0xd012));
         }
 
         static void updateMetrics() noexcept;
@@ -110,16 +130,16 @@ class Video {
         static void putStrCharData(uint8_t x, uint8_t y, const char* data, uint8_t data_ofs, uint8_t col) noexcept;
 
         static inline void putc(uint8_t x, uint8_t y, uint8_t c) noexcept {
-            *((address_t) row_addresses[y] + x) = c;
+            *(to_ptr(row_addresses[y]) + x) = c;
         }
 
         static inline void putc(uint8_t x, uint8_t y, uint8_t c, uint8_t col) noexcept {
-            *((address_t) row_addresses[y] + x) = c;
-            *((address_t) col_addresses[y] + x) = col;
+            *(to_ptr(row_addresses[y]) + x) = c;
+            *(to_ptr(col_addresses[y]) + x) = col;
         }
 
         [[nodiscard]] static inline uint8_t getc(uint8_t x, uint8_t y) noexcept {
-            return *((address_t) row_addresses[y] + x);
+            return *(to_ptr(row_addresses[y]) + x);
         }
 
         static void printNumber(uint8_t x, uint8_t y, uint8_t n) noexcept;
@@ -137,6 +157,7 @@ class Video {
     private:
         static void setScreenPtrs() noexcept;
         static void setColorPtrs() noexcept;
+        static void accountFrame(uint8_t frames_elapsed, uint16_t line) noexcept;
 
     private:
         struct raster_step_t {
@@ -147,19 +168,22 @@ class Video {
     private:
         static metrics_t metrics_;
         static volatile stats_t stats_;
+        static SpriteCommandQueue sprite_commands;
         static volatile uint8_t last_frame_counter_;
+        static uint16_t loop_start_line_;
         static bool raster_irq_enabled;
-        static raster_step_t raster_sequence[8];
+        LIBCPP64_ZEROPAGE_DATA static raster_step_t raster_sequence[8];
         static uint16_t row_addresses[25];
         static uint16_t col_addresses[25];
-        static volatile uint8_t raster_sequence_step;
-        static uint8_t raster_sequence_step_count;
+        LIBCPP64_ZEROPAGE static volatile uint8_t raster_sequence_step;
+        LIBCPP64_ZEROPAGE static uint8_t raster_sequence_step_count;
         static uint16_t vic_base;
         static uint16_t screen_base;
         static uint16_t char_base;
         static uint16_t bitmap_base;
         static uint16_t color_base;
         static uint16_t sprite_base;
+        static uint16_t sprite_data;
 };
 
 }  // namespace sys
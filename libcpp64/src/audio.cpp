@@ -4,70 +4,156 @@
 
 #include "libcpp64/audio.h"
 
-extern const uint8_t music[];
-extern const size_t music_size;
-extern const unsigned short music_load_address;
-extern const unsigned short music_init_address;
-extern const unsigned short music_play_address;
-extern const unsigned short music_num_songs;
-extern const unsigned char music_start_song;
-
+// provided by the sidc generated music source. the sid data is
+// linked to its load address, init/play addresses are link-time constants.
 extern "C" void init_audio(void);
 extern "C" void update_audio(void);
+extern const bool music_shadowed;
 
-asm (
-  ".text\n"
-
-  ".global init_audio\n"
-  "init_audio:\n"                       // called once
-
-  // self-modify init JSR jump address
-  "  lda music_init_address\n"          // load init address hi
-  "  sta 0f+1\n"                        // patch JSR address
-  "  lda music_init_address+1\n"        // load init address lo
-  "  sta 0f+2\n"                        // patch JSR address
-
-  // self-modify update JSR jump address
-  "  lda music_play_address\n"          // load play address hi
-  "  sta 1f+1\n"                        // patch JSR address
-  "  lda music_play_address+1\n"        // load play address lo
-  "  sta 1f+2\n"                        // patch JSR address
-
-  // call init
-  "  ldx music_start_song\n"            // get tune number
-  "  dex\n"                             // zero-based
-  "  txa\n"                             // store tune number to register A
-  "  ldx #0\n"                          // clear register X
-  "  ldy #0\n"                          // clear register Y
-  "0:\n"
-  "  jsr $5000\n"                       // jsr, address will be overwritten
-  "  rts\n"                             // return
-
-  ".global update_audio\n"
-  "update_audio:\n"                     // called every cycle
-
-  // call update
-  "1:\n"
-  "  jsr $5003\n"                       // jsr, address will be overwritten
-  "  rts\n"                             // return
-);
+// sid register shadow. players converted with 'sidc -s' write here
+// instead of $d400, registers are flushed to the sid after each update.
+extern "C" uint8_t audio_sid_shadow[25];
+uint8_t audio_sid_shadow[25]{};
 
 using namespace sys;
 
-void Audio::init() {
+static const uint8_t effect_stop[] = { Audio::FX_END };
 
-    // copy sid data to load address
-    const void* srcAddress = (const void*) music;
-    void* loadAddress = (void*) music_load_address;
-    if (loadAddress != srcAddress) {
-        memcpy(loadAddress, srcAddress, music_size);
-    }
+Audio::stats_t Audio::stats_{};
+bool Audio::effects_enabled{true};
+const uint8_t* Audio::effect_stream{nullptr};
+uint8_t Audio::effect_regs[7]{};
+int16_t Audio::effect_slide{0};
+uint8_t Audio::effect_wait{0};
+uint8_t Audio::effect_priority{0};
+uint8_t Audio::effect_voice_ofs{14};
+Audio::EffectQueue Audio::effect_requests{};
 
+void Audio::init() {
     init_audio();
 }
 
 void Audio::update() {
-{
+    uint8_t start_line = memory(0xd012);
+
     update_audio();
+
+    if (!effect_requests.empty()) startEffects();
+    if (music_shadowed) flushShadowRegisters();
+    if (effect_stream) updateEffect();
+
+    uint8_t lines = memory(0xd012) - start_line;
+    stats_.update_lines = lines;
+    if (lines > stats_.update_lines_max) stats_.update_lines_max = lines;
+}
+
+void Audio::setEffectVoice(uint8_t voice) noexcept {
+    // stops a running effect, the voice changes in the next update (irq)
+    if (!effects_enabled) return;
+    (void) effect_requests.push(effect_request_t{effect_stop, 0xff, (uint8_t) ((voice % 3) * 7)});
+}
+
+bool Audio::playEffect(const uint8_t* effect, uint8_t priority) noexcept {
+    // picked up by the next update (irq). fails if the irq doesn't
+    // run Audio::update (src/raster.asm only plays the music)
+    if (!effects_enabled) return false;
+    return effect_requests.push(effect_request_t{effect, priority});
+}
+
+void Audio::stopEffect() noexcept {
+    (void) playEffect(effect_stop, 0xff);
+}
+
+void Audio::startEffects() noexcept {
+    effect_request_t request;
+    while (effect_requests.pop(request)) {
+        if (request.stream == effect_stop) {
+            // stop now, so the old voice is released before a voice change
+            if (effect_stream) endEffect();
+            if (request.voice_ofs != NoVoiceChange) effect_voice_ofs = request.voice_ofs;
+            continue;
+        }
+
+        if (effect_stream && request.priority < effect_priority) continue;
+
+        effect_stream = request.stream;
+        effect_priority = request.priority;
+        effect_wait = 0;
+        effect_slide = 0;
+        effect_regs[4] = 0x0;
+    }
+}
+
+void Audio::flushShadowRegisters() noexcept {
+    // skip the voice owned by a sound effect. 0x80 never matches,
+    // reg - 0x80 is >= 7 for all sid registers
+    uint8_t skip_ofs = effect_stream ? effect_voice_ofs : 0x80;
+
+    uint8_t reg = 0x18;
+    do {
+        if ((uint8_t) (reg - skip_ofs) >= 7) {
+            memory(0xd400 + reg) = audio_sid_shadow[reg];
+        }
+    } while (reg-- != 0);
 }
+
+void Audio::endEffect() noexcept {
+    // hand the voice back to the music. a shadowed player gets its
+    // registers restored by the next flush, otherwise release the gate.
+    if (!music_shadowed) {
+        memory(0xd404 + effect_voice_ofs) = effect_regs[4] & 0xfe;
+    }
+    effect_stream = nullptr;
+    effect_priority = 0;
+}
+
+void Audio::updateEffect() noexcept {
+
+    if (effect_wait > 0) {
+        effect_wait--;
+    } else {
+        uint8_t commands = MaxEffectCommands;
+        const uint8_t* s = effect_stream;
+        while (commands-- > 0) {
+            uint8_t cmd = *(s++);
+            if (cmd == FX_WAIT) {
+                effect_wait = *(s++);
+                break;
+            } else if (cmd == FX_FREQ) {
+                effect_regs[0] = *(s++);
+                effect_regs[1] = *(s++);
+            } else if (cmd == FX_PULSE) {
+                effect_regs[2] = *(s++);
+                effect_regs[3] = *(s++);
+            } else if (cmd == FX_ADSR) {
+                effect_regs[5] = *(s++);
+                effect_regs[6] = *(s++);
+            } else if (cmd == FX_CTRL) {
+                effect_regs[4] = *(s++);
+            } else if (cmd == FX_SLIDE) {
+                effect_slide = (int16_t) (s[0] | (s[1] << 8));
+                s += 2;
+            } else {
+                endEffect();
+                return;
+            }
+        }
+        effect_stream = s;
+    }
+
+    if (effect_slide != 0) {
+        uint16_t freq = (uint16_t) (effect_regs[0] | (effect_regs[1] << 8)) + effect_slide;
+        effect_regs[0] = (uint8_t) (freq & 0xff);
+        effect_regs[1] = (uint8_t) (freq >> 8);
+    }
+
+    // envelope before control register, so a gate-on sees the new ADSR
+    const uint16_t voice = 0xd400 + effect_voice_ofs;
+    memory(voice + 0) = effect_regs[0];
+    memory(voice + 1) = effect_regs[1];
+    memory(voice + 2) = effect_regs[2];
+    memory(voice + 3) = effect_regs[3];
+    memory(voice + 5) = effect_regs[5];
+    memory(voice + 6) = effect_regs[6];
+    memory(voice + 4) = effect_regs[4];
 }
@@ -1,8 +1,9 @@
 #include <cstdint>
 
 #include "libcpp64/auxiliary.h"
+#include "libcpp64/placement.h"
 
-const uint8_t __random_numbers[] = { // pre-randomize 256 8-bit integers
+LIBCPP64_PAGE_ALIGNED const uint8_t __random_numbers[256] = { // pre-randomize 256 8-bit integers
     203,22,77,162,177,233,222,231,130,85,19,117,28,206,23,200,118,217,29,207,
     138,41,174,201,224,52,235,133,208,108,11,168,226,199,91,99,123,170,160,1,
     83,111,150,102,161,8,127,53,13,253,164,70,191,244,4,49,68,135,112,82,96,
@@ -18,7 +19,7 @@ const uint8_t __random_numbers[] = { // pre-randomize 256 8-bit integers
     254,229,56,165,97,190,2
 };
 
-static uint8_t rnd_index = 0;
+LIBCPP64_ZEROPAGE static uint8_t rnd_index;
 [[nodiscard]] uint8_t sys::rand() noexcept {
     return __random_numbers[rnd_index++];
 }
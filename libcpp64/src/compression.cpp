@@ -0,0 +1,118 @@
+#include <cstddef>
+#include <cstdint>
+
+#include "libcpp64/compression.h"
+
+using namespace sys;
+
+static inline uint16_t read_length(const uint8_t*& src, uint16_t len) {
+    if (len == 15) {
+        uint8_t b;
+        do {
+            b = *(src++);
+            len += b;
+        } while (b == 255);
+    }
+    return len;
+}
+
+uint8_t* Compression::unpack(const uint8_t* src, uint8_t* dest) noexcept {
+    const uint8_t* end = dest + getUnpackedSize(src);
+    src += 2;
+
+    while (dest < end) {
+        uint8_t token = *(src++);
+
+        // literals
+        uint16_t len = read_length(src, token >> 4);
+        while (len--) {
+            *(dest++) = *(src++);
+        }
+
+        if (dest >= end) break;
+
+        // match, byte-wise copy handles overlapping
+        uint16_t offset = (uint16_t) (src[0] | (src[1] << 8));
+        src += 2;
+
+        const uint8_t* match = dest - offset;
+        len = read_length(src, token & 0xf) + 4;
+        while (len--) {
+            *(dest++) = *(match++);
+        }
+    }
+
+    return dest;
+}
+
+void StreamUnpacker::begin(uint8_t* dest) noexcept {
+    dest_ = dest;
+    end_ = dest;
+    state_ = State::Size0;
+}
+
+[[nodiscard]] bool StreamUnpacker::put(uint8_t value) noexcept {
+    switch (state_) {
+        case State::Size0:
+            length_ = value;
+            state_ = State::Size1;
+            break;
+        case State::Size1:
+            end_ = dest_ + (uint16_t) (length_ | (value << 8));
+            state_ = (dest_ < end_) ? State::Token : State::Done;
+            break;
+        case State::Token:
+            token_ = value;
+            length_ = token_ >> 4;
+            if (15 == length_) {
+                state_ = State::LiteralLength;
+            } else if (0 != length_) {
+                state_ = State::Literals;
+            } else {
+                endLiterals();
+            }
+            break;
+        case State::LiteralLength:
+            length_ += value;
+            if (255 != value) state_ = State::Literals;
+            break;
+        case State::Literals:
+            *(dest_++) = value;
+            if (0 == --length_) endLiterals();
+            break;
+        case State::Offset0:
+            offset_ = value;
+            state_ = State::Offset1;
+            break;
+        case State::Offset1:
+            offset_ |= (uint16_t) (value << 8);
+            length_ = token_ & 0xf;
+            if (15 == length_) {
+                state_ = State::MatchLength;
+            } else {
+                copyMatch();
+            }
+            break;
+        case State::MatchLength:
+            length_ += value;
+            if (255 != value) copyMatch();
+            break;
+        case State::Done:
+            break;
+    }
+
+    return State::Done != state_;
+}
+
+void StreamUnpacker::endLiterals() noexcept {
+    state_ = (dest_ < end_) ? State::Offset0 : State::Done;
+}
+
+void StreamUnpacker::copyMatch() noexcept {
+    const uint8_t* match = dest_ - offset_;
+    uint16_t len = length_ + 4;
+    while (len--) {
+        *(dest_++) = *(match++);
+    }
+    state_ = (dest_ < end_) ? State::Token : State::Done;
+}
@@ -0,0 +1,156 @@
+#include <cstddef>
+#include <cstdint>
+#include <cbm.h>
+
+#include "libcpp64/drive.h"
+
+using namespace sys;
+
+static const uint8_t command_channel = 15;
+
+// sector checksum, runs at $0500 in drive RAM. reads track/sector given
+// at $05f0/$05f1 into buffer 3 ($0600) via the job queue, stores the job
+// result at $05f2 (1 = ok) and the xor checksum of the sector at $05f3.
+static const uint16_t checksum_params = 0x05f0;
+static const uint8_t checksum_code[] = {
+    0xad, 0xf0, 0x05,           //          lda $05f0
+    0x85, 0x0c,                 //          sta $0c         ; buffer 3 track
+    0xad, 0xf1, 0x05,           //          lda $05f1
+    0x85, 0x0d,                 //          sta $0d         ; buffer 3 sector
+    0xa9, 0x80,                 //          lda #$80        ; job: read sector
+    0x85, 0x03,                 //          sta $03         ; buffer 3 job code
+    0xa5, 0x03,                 // wait:    lda $03
+    0x30, 0xfc,                 //          bmi wait
+    0x8d, 0xf2, 0x05,           //          sta $05f2       ; job result
+    0xa2, 0x00,                 //          ldx #0
+    0x8a,                       //          txa
+    0x5d, 0x00, 0x06,           // sum:     eor $0600,x
+    0xe8,                       //          inx
+    0xd0, 0xfa,                 //          bne sum
+    0x8d, 0xf3, 0x05,           //          sta $05f3
+    0x60                        //          rts
+};
+
+uint8_t Drive::device{8};
+bool Drive::checksum_uploaded{false};
+
+void Drive::init(uint8_t device_number) noexcept {
+    device = device_number;
+    checksum_uploaded = false;
+}
+
+[[nodiscard]] bool Drive::upload(uint16_t drive_address, const uint8_t* data, uint16_t size) noexcept {
+    if (!open()) return false;
+
+    bool ok = true;
+    while (ok && size > 0) {
+        uint8_t count = (size > MaxWriteSize) ? MaxWriteSize : (uint8_t) size;
+        ok = memoryWrite(drive_address, data, count);
+        drive_address += count;
+        data += count;
+        size -= count;
+    }
+
+    close();
+
+    return ok;
+}
+
+[[nodiscard]] bool Drive::execute(uint16_t drive_address) noexcept {
+    if (!open()) return false;
+
+    const uint8_t command[] = { 'M', '-', 'E', (uint8_t) (drive_address & 0xff), (uint8_t) (drive_address >> 8) };
+    bool ok = sendCommand(command, sizeof(command));
+
+    close();
+
+    return ok;
+}
+
+[[nodiscard]] bool Drive::read(uint16_t drive_address, uint8_t* dest, uint8_t size) noexcept {
+    if (!open()) return false;
+
+    const uint8_t command[] = { 'M', '-', 'R', (uint8_t) (drive_address & 0xff), (uint8_t) (drive_address >> 8), size };
+    bool ok = sendCommand(command, sizeof(command));
+
+    if (ok) {
+        System::beginKernalAccess();
+        ok = (0 == cbm_k_chkin(command_channel));
+        if (ok) {
+            // the destination may be ram under the kernal rom, writes go to ram
+            while (size--) *(dest++) = cbm_k_chrin();
+            ok = (0 == (cbm_k_readst() & 0x83));  // no timeout, device present
+        }
+        cbm_k_clrch();
+        System::endKernalAccess();
+    }
+
+    close();
+
+    return ok;
+}
+
+[[nodiscard]] bool Drive::sectorChecksum(uint8_t track, uint8_t sector, uint8_t& checksum) noexcept {
+    if (!checksum_uploaded) {
+        if (!upload(CodeAddress, checksum_code, sizeof(checksum_code))) return false;
+        checksum_uploaded = true;
+    }
+
+    const uint8_t params[] = { track, sector };
+    if (!upload(checksum_params, params, sizeof(params))) return false;
+    if (!execute(CodeAddress)) return false;
+
+    uint8_t result[2];
+    if (!read(checksum_params + 2, result, sizeof(result))) return false;
+
+    checksum = result[1];
+    return (0x01 == result[0]);
+}
+
+bool Drive::open() noexcept {
+    System::beginKernalAccess();
+
+    cbm_k_setlfs(command_channel, device, command_channel);
+    cbm_k_setnam("");
+    bool ok = (0 == cbm_k_open());
+    if (!ok) cbm_k_close(command_channel);
+
+    System::endKernalAccess();
+
+    return ok;
+}
+
+void Drive::close() noexcept {
+    System::beginKernalAccess();
+    cbm_k_close(command_channel);
+    System::endKernalAccess();
+}
+
+bool Drive::sendCommand(const uint8_t* command, uint8_t size) noexcept {
+    System::beginKernalAccess();
+
+    bool ok = (0 == cbm_k_ckout(command_channel));
+    if (ok) {
+        for (uint8_t i=0; i<size; i++) cbm_k_chrout(command[i]);
+    }
+    cbm_k_clrch();                      // unlisten, the drive executes the command
+
+    System::endKernalAccess();
+
+    return ok;
+}
+
+bool Drive::memoryWrite(uint16_t drive_address, const uint8_t* data, uint8_t size) noexcept {
+    uint8_t command[3 + 3 + MaxWriteSize];
+    command[0] = 'M';
+    command[1] = '-';
+    command[2] = 'W';
+    command[3] = (uint8_t) (drive_address & 0xff);
+    command[4] = (uint8_t) (drive_address >> 8);
+    command[5] = size;
+
+    // copy with the default memory map, data may be in ram under the kernal rom
+    for (uint8_t i=0; i<size; i++) command[6 + i] = data[i];
+
+    return sendCommand(command, 6 + size);
+}
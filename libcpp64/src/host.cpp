@@ -0,0 +1,182 @@
+#include <cstddef>
+#include <cstdint>
+#include <string.h>
+
+#include "libcpp64/system.h"
+
+using namespace sys;
+
+// defaults for the symbols provided by generated sources in the target build
+extern "C" __attribute__((weak)) void init_audio(void) {}
+extern "C" __attribute__((weak)) void update_audio(void) {}
+extern __attribute__((weak)) const bool music_shadowed{false};
+extern __attribute__((weak)) const uint8_t sprites[]{0};
+extern __attribute__((weak)) const size_t sprites_size{0};
+
+uint8_t Host::ram[0x10000]{};
+Host::read_hook_t Host::read_hooks[256]{};
+Host::write_hook_t Host::write_hooks[256]{};
+uint16_t Host::raster_line{0};
+uint16_t Host::raster_compare{0};
+uint16_t Host::raster_lines{Constants::RasterLines};
+uint8_t Host::key_matrix[8]{};
+uint8_t Host::joystick[2]{};
+interrupt_handler_t Host::interrupt_handler{nullptr};
+bool Host::interrupts_enabled{true};
+bool Host::in_interrupt{false};
+bool Host::initialized{false};        // constant initialized, safe before static constructors
+
+void Host::reset() noexcept {
+    memset(ram, 0x0, sizeof(ram));
+    init();
+
+    raster_line = 0;
+    raster_compare = 0;
+    raster_lines = Constants::RasterLines;
+    memset(key_matrix, 0x0, sizeof(key_matrix));
+    memset(joystick, 0x0, sizeof(joystick));
+    interrupt_handler = nullptr;
+    interrupts_enabled = true;
+    in_interrupt = false;
+}
+
+void Host::init() noexcept {
+    // first access: install the hooks, keep ram contents written through to_ptr()
+    initialized = true;
+
+    ram[0x01] = 0x37;                   // basic, kernal and i/o visible
+    ram[0xd011] = 0x1b;
+
+    for (auto& hook : read_hooks) hook = nullptr;
+    for (auto& hook : write_hooks) hook = nullptr;
+
+    for (uint8_t page=0xd0; page<0xd4; page++) {
+        read_hooks[page] = readVic;
+        write_hooks[page] = writeVic;
+    }
+    for (uint8_t page=0xd4; page<0xd8; page++) {
+        read_hooks[page] = readSid;
+        write_hooks[page] = writeSid;
+    }
+    read_hooks[0xdc] = readCia1;
+    read_hooks[0xde] = readOpenBus;
+    read_hooks[0xdf] = readOpenBus;
+}
+
+void Host::setReadHook(uint8_t page, read_hook_t hook) noexcept {
+    if (!initialized) init();
+    read_hooks[page] = hook;
+}
+
+void Host::setWriteHook(uint8_t page, write_hook_t hook) noexcept {
+    if (!initialized) init();
+    write_hooks[page] = hook;
+}
+
+uint8_t Host::read(uint16_t address) noexcept {
+    if (!initialized) init();
+    auto hook = read_hooks[address >> 8];
+    return hook ? hook(address) : ram[address];
+}
+
+void Host::write(uint16_t address, uint8_t value) noexcept {
+    if (!initialized) init();
+    auto hook = write_hooks[address >> 8];
+    if (hook) {
+        hook(address, value);
+    } else {
+        ram[address] = value;
+    }
+}
+
+void Host::advanceRaster(uint16_t lines) noexcept {
+    while (lines--) {
+        raster_line++;
+        if (raster_line >= raster_lines) raster_line = 0;
+
+        if (raster_line == raster_compare) {
+            ram[0xd019] |= 0x81;        // raster irq flag
+            if (ram[0xd01a] & 0x01) raiseInterrupt();
+        }
+    }
+}
+
+void Host::raiseInterrupt() noexcept {
+    if (!interrupts_enabled || in_interrupt || nullptr == interrupt_handler) return;
+    in_interrupt = true;
+    interrupt_handler();
+    in_interrupt = false;
+}
+
+uint8_t Host::readVic(uint16_t address) noexcept {
+    address = 0xd000 + (address & 0x3f); // registers repeat every 64 bytes
+    switch (address) {
+        case 0xd011:
+            advanceRaster(1);
+            return (uint8_t) ((ram[address] & 0x7f) | ((raster_line >> 1) & 0x80));
+        case 0xd012:
+            advanceRaster(1);
+            return (uint8_t) (raster_line & 0xff);
+        default:
+            return ram[address];
+    }
+}
+
+void Host::writeVic(uint16_t address, uint8_t value) noexcept {
+    address = 0xd000 + (address & 0x3f);
+    switch (address) {
+        case 0xd011:
+            ram[address] = value;
+            raster_compare = (uint16_t) ((raster_compare & 0xff) | ((value & 0x80) << 1));
+            break;
+        case 0xd012:
+            raster_compare = (uint16_t) ((raster_compare & 0x100) | value);
+            break;
+        case 0xd019:
+            ram[address] &= (uint8_t) ~value; // writing 1 bits acknowledges
+            if (0 == (ram[address] & 0x0f)) ram[address] = 0x0;
+            break;
+        default:
+            ram[address] = value;
+            break;
+    }
+}
+
+uint8_t Host::readSid(uint16_t address) noexcept {
+    address = 0xd400 + (address & 0x1f); // registers repeat every 32 bytes
+    if (address >= 0xd419) return ram[address];         // paddles, oscillator 3, envelope 3
+    return 0x0;                                         // write-only
+}
+
+void Host::writeSid(uint16_t address, uint8_t value) noexcept {
+    address = 0xd400 + (address & 0x1f);
+    if (address < 0xd419) ram[address] = value;         // see getSidRegister
+}
+
+uint8_t Host::readCia1(uint16_t address) noexcept {
+    switch (address & 0x0f) {
+        case 0x00: // port a: selected rows, joystick 2
+            return (uint8_t) (ram[0xdc00] & ~joystick[1]);
+        case 0x01: { // port b: columns of the selected rows, joystick 1
+            uint8_t rows = (uint8_t) ~ram[0xdc00];
+            uint8_t columns = 0x0;
+            for (uint8_t row=0; row<8; row++) {
+                if (rows & (1 << row)) columns |= key_matrix[row];
+            }
+            return (uint8_t) ~(columns | joystick[0]);
+        }
+        default:
+            return ram[0xdc00 + (address & 0x0f)];
+    }
+}
+
+uint8_t Host::readOpenBus(uint16_t address) noexcept {
+    (void) address;
+    return 0xff;
+}
+
+void Host::setKey(uint8_t keycode, bool pressed) noexcept {
+    uint8_t& row = key_matrix[(keycode >> 4) & 0x7];
+    uint8_t bit = (uint8_t) (1 << (keycode & 0x7));
+    row = pressed ? (uint8_t) (row | bit) : (uint8_t) (row & ~bit);
+}
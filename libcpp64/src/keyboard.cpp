@@ -5,6 +5,13 @@
 
 using namespace sys;
 
+LIBCPP64_ZEROPAGE_DATA uint8_t Keyboard::keyboard_buffer[8]{0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff};
+uint8_t Keyboard::keyboard_state[8]{};
+uint8_t Keyboard::keyboard_last[8]{};
+bool Keyboard::keyboard_active{false};
+uint8_t Keyboard::joystick_state[2]{};
+Keyboard::EventQueue Keyboard::events{};
+
 void Keyboard::init() noexcept {
     memory(0xDC02) = 0xff;  // CIA1 port A = outputs
     memory(0xDC03) = 0x0;   // CIA1 port B = inputs
@@ -41,3 +48,84 @@ void Keyboard::store() noexcept {
     uint8_t bitnum = (keycode & 0x07);
     return (bits & (1<<bitnum)) == 0x0;
 }
+
+void Keyboard::scan() noexcept {
+    memory(0xdc00) = 0xff;                              // deselect all rows
+    uint8_t joy1 = ~memory(0xdc01) & 0x1f;              // joystick port 1 shares the column lines
+    joystick_state[0] = joy1;
+    joystick_state[1] = ~memory(0xdc00) & 0x1f;         // joystick port 2
+
+    memory(0xdc00) = 0x00;                              // select all rows
+    uint8_t any = memory(0xdc01) | joy1;                // single read: any key pressed?
+    if (any == 0xff && !keyboard_active) {
+        memory(0xdc00) = 0xff;
+        return;                                         // idle
+    }
+
+    uint8_t row_select = 0xfe;
+    for (uint8_t row=0; row<8; row++) {
+        memory(0xdc00) = row_select;
+        keyboard_buffer[row] = memory(0xdc01) | joy1;
+        row_select = (row_select << 1) | 0x1;
+    }
+    memory(0xdc00) = 0xff;
+
+    uint8_t ghost_rows = getGhostRows();
+
+    keyboard_active = false;
+    uint8_t row_bit = 0x1;
+    for (uint8_t row=0; row<8; row++) {
+        uint8_t raw = ~keyboard_buffer[row];
+        uint8_t state = keyboard_state[row];
+        if (ghost_rows & row_bit) raw = state;           // ambiguous, keep previous state
+
+        uint8_t agreed = ~(raw ^ keyboard_last[row]);   // debounce: same in two scans
+        uint8_t next = (state & ~agreed) | (raw & agreed);
+        keyboard_last[row] = raw;
+
+        uint8_t changed = state ^ next;
+        if (changed) {
+            keyboard_state[row] = next;
+            pushEdges(row, changed, next);
+        }
+
+        if (next | raw) keyboard_active = true;
+        row_bit <<= 1;
+    }
+}
+
+uint8_t Keyboard::getGhostRows() noexcept {
+    // three keys at the corners of a rectangle in the matrix make the
+    // fourth corner appear pressed. such rows share two or more columns.
+    uint8_t ghost_rows = 0x0;
+    for (uint8_t i=0; i<7; i++) {
+        uint8_t a = ~keyboard_buffer[i];
+        if (!(a & (a - 1))) continue;                   // less than two keys
+        for (uint8_t j=i+1; j<8; j++) {
+            uint8_t common = a & ~keyboard_buffer[j];
+            if (common & (common - 1)) {
+                ghost_rows |= (1 << i) | (1 << j);
+            }
+        }
+    }
+    return ghost_rows;
+}
+
+void Keyboard::pushEdges(uint8_t row, uint8_t changed, uint8_t state) noexcept {
+    uint8_t col_bit = 0x1;
+    for (uint8_t col=0; col<8; col++) {
+        if (changed & col_bit) {
+            uint8_t event = (row << 4) | col | ((state & col_bit) ? 0x0 : EVENT_KEY_UP);
+            if (!events.push(event)) return;            // queue full, drop
+        }
+        col_bit <<= 1;
+    }
+}
+
+[[nodiscard]] bool Keyboard::pollEvent(uint8_t& event) noexcept {
+    return events.pop(event);
+}
+
+[[nodiscard]] bool Keyboard::isKeyDown(uint8_t keycode) noexcept {
+    return (keyboard_state[keycode>>4] & (1<<(keycode & 0x07))) != 0x0;
+}
@@ -0,0 +1,125 @@
+#include <cstddef>
+#include <cstdint>
+#include <cbm.h>
+
+#include "libcpp64/loader.h"
+#include "libcpp64/trace.h"
+
+using namespace sys;
+
+static const uint8_t file_number = 2;
+static const uint8_t secondary_address = 2;
+static const uint8_t status_eof = 0x40;
+static const uint8_t status_device_not_present = 0x80;
+
+Loader::RequestQueue Loader::requests{};
+Loader::request_t Loader::current{};
+Loader::State Loader::state{Loader::State::Idle};
+uint8_t Loader::device{8};
+uint8_t* Loader::dest{nullptr};
+uint8_t Loader::read_status{0};
+uint8_t Loader::chunk[ChunkSize]{};
+StreamUnpacker Loader::unpacker{};
+
+void Loader::init(uint8_t device_number) noexcept {
+    device = device_number;
+    state = State::Idle;
+    requests.clear();
+}
+
+[[nodiscard]] bool Loader::load(const char* name, uint8_t* destination, callback_t callback, uint8_t flags) noexcept {
+    return requests.push(request_t{name, destination, callback, flags});
+}
+
+void Loader::update() noexcept {
+    if (State::Idle == state) {
+        if (!requests.pop(current)) return;
+
+        Trace::event(Trace::EventLoadBegin);
+
+        dest = current.dest;
+        if (current.flags & FLAG_UNPACK) unpacker.begin(dest);
+
+        if (!open()) {
+            finish(STATUS_OPEN_FAILED);
+            return;
+        }
+
+        state = State::Data;
+    }
+
+    uint8_t count = (0 == read_status) ? readChunk() : 0;
+
+    // copy with the default memory map, the destination
+    // may be ram under the kernal rom
+    const uint8_t* src = chunk;
+    if (current.flags & FLAG_UNPACK) {
+        while (count--) (void) unpacker.put(*(src++));
+        dest = unpacker.getDest();
+    } else {
+        while (count--) *(dest++) = *(src++);
+    }
+
+    if (0 != read_status) {
+        close();
+        finish((read_status & ~status_eof) ? STATUS_READ_ERROR : STATUS_OK);
+    }
+}
+
+bool Loader::open() noexcept {
+    System::beginKernalAccess();
+
+    cbm_k_setlfs(file_number, device, secondary_address);
+    cbm_k_setnam(current.name);
+
+    bool ok = (0 == cbm_k_open());
+    if (ok) ok = (0 == cbm_k_chkin(file_number));
+
+    if (ok) {
+        (void) cbm_k_chrin();           // skip load address
+        (void) cbm_k_chrin();
+        read_status = cbm_k_readst();
+    }
+
+    cbm_k_clrch();
+    if (!ok) cbm_k_close(file_number);
+
+    System::endKernalAccess();
+
+    return ok;
+}
+
+uint8_t Loader::readChunk() noexcept {
+    uint8_t count = 0;
+
+    System::beginKernalAccess();
+
+    if (0 == cbm_k_chkin(file_number)) {
+        while (count < ChunkSize) {
+            chunk[count++] = cbm_k_chrin();
+            read_status = cbm_k_readst();
+            if (0 != read_status) break;
+        }
+    } else {
+        read_status = status_device_not_present;
+    }
+
+    cbm_k_clrch();
+
+    System::endKernalAccess();
+
+    return count;
+}
+
+void Loader::close() noexcept {
+    System::beginKernalAccess();
+    cbm_k_close(file_number);
+    System::endKernalAccess();
+}
+
+void Loader::finish(uint8_t status) noexcept {
+    Trace::event8(Trace::EventLoadEnd, status);
+    state = State::Idle;
+    read_status = 0;
+    if (current.callback) current.callback(status, dest);
+}
@@ -0,0 +1,184 @@
+#include <cstddef>
+#include <cstdint>
+
+#include "libcpp64/math.h"
+
+using namespace sys;
+
+//
+// Lookup tables, generated at compile time and page aligned
+// so indexed reads never pay a page crossing penalty.
+//
+
+namespace {
+
+constexpr double pi = 3.14159265358979323846;
+
+constexpr double const_sin(double x) {
+    while (x > pi) x -= 2.0 * pi;
+    while (x < -pi) x += 2.0 * pi;
+    double term = x;
+    double sum = x;
+    for (int n=1; n<12; n++) {
+        term = -term * x * x / ((2 * n) * (2 * n + 1));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr double const_atan(double t) { // 0 <= t <= 1
+    double ofs = 0.0;
+    if (t > 0.4142) {
+        ofs = pi / 4.0;
+        t = (t - 1.0) / (t + 1.0);
+    }
+    double term = t;
+    double sum = t;
+    for (int n=1; n<24; n++) {
+        term = -term * t * t;
+        sum += term / (2 * n + 1);
+    }
+    return ofs + sum;
+}
+
+constexpr int const_round(double v) {
+    return (v >= 0.0) ? (int) (v + 0.5) : -(int) (-v + 0.5);
+}
+
+struct sqr_table_t {
+    uint8_t lo[512];
+    uint8_t hi[512];
+};
+
+constexpr sqr_table_t make_sqr_table() {
+    sqr_table_t t{};
+    for (uint16_t i=0; i<512; i++) {
+        uint16_t q = (uint16_t) (((uint32_t) i * i) / 4);
+        t.lo[i] = (uint8_t) (q & 0xff);
+        t.hi[i] = (uint8_t) (q >> 8);
+    }
+    return t;
+}
+
+struct recip_table_t {
+    uint8_t lo[256];
+    uint8_t hi[256];
+};
+
+constexpr recip_table_t make_recip_table() {
+    recip_table_t t{};
+    for (uint16_t d=2; d<256; d++) {
+        uint16_t r = (uint16_t) ((65536UL + d - 1) / d); // ceil(65536/d)
+        t.lo[d] = (uint8_t) (r & 0xff);
+        t.hi[d] = (uint8_t) (r >> 8);
+    }
+    return t;
+}
+
+struct trig_table_t {
+    int8_t sin[256];
+    uint8_t atan[256];   // atan(i/256) in 1/256 circle units
+};
+
+constexpr trig_table_t make_trig_table() {
+    trig_table_t t{};
+    for (uint16_t i=0; i<256; i++) {
+        t.sin[i] = (int8_t) const_round(127.0 * const_sin(2.0 * pi * i / 256.0));
+        t.atan[i] = (uint8_t) const_round(const_atan(i / 256.0) * 256.0 / (2.0 * pi));
+    }
+    return t;
+}
+
+alignas(256) constexpr sqr_table_t sqr_table = make_sqr_table();
+alignas(256) constexpr recip_table_t recip_table = make_recip_table();
+alignas(256) constexpr trig_table_t trig_table = make_trig_table();
+
+static_assert(sqr_table.hi[510] == 0xfe && sqr_table.lo[510] == 0x01, "quarter square table");
+static_assert(trig_table.sin[64] == 127 && trig_table.sin[192] == -127, "sine table");
+static_assert(trig_table.atan[255] == 32, "atan table");
+
+inline uint16_t sqr(uint16_t i) {
+    return (uint16_t) ((sqr_table.hi[i] << 8) | sqr_table.lo[i]);
+}
+
+inline uint32_t mul16x8(uint16_t a, uint8_t b) {
+    return Math::mul8x8((uint8_t) (a & 0xff), b) + ((uint32_t) Math::mul8x8((uint8_t) (a >> 8), b) << 8);
+}
+
+}  // namespace
+
+[[nodiscard]] uint16_t Math::mul8x8(uint8_t a, uint8_t b) noexcept {
+    // a*b = (a+b)^2/4 - (a-b)^2/4
+    uint16_t sum = (uint16_t) a + b;
+    uint8_t diff = (a >= b) ? a - b : b - a;
+    return sqr(sum) - sqr(diff);
+}
+
+[[nodiscard]] int16_t Math::mul8x8s(int8_t a, int8_t b) noexcept {
+    bool negative = (a < 0) != (b < 0);
+    uint16_t p = mul8x8((uint8_t) (a < 0 ? -a : a), (uint8_t) (b < 0 ? -b : b));
+    return negative ? -(int16_t) p : (int16_t) p;
+}
+
+[[nodiscard]] uint32_t Math::mul16x16(uint16_t a, uint16_t b) noexcept {
+    uint8_t al = (uint8_t) (a & 0xff);
+    uint8_t ah = (uint8_t) (a >> 8);
+    uint8_t bl = (uint8_t) (b & 0xff);
+    uint8_t bh = (uint8_t) (b >> 8);
+
+    uint32_t p = mul8x8(al, bl);
+    p += (uint32_t) mul8x8(ah, bl) << 8;
+    p += (uint32_t) mul8x8(al, bh) << 8;
+    p += (uint32_t) mul8x8(ah, bh) << 16;
+    return p;
+}
+
+[[nodiscard]] int32_t Math::mul16x16s(int16_t a, int16_t b) noexcept {
+    bool negative = (a < 0) != (b < 0);
+    uint32_t p = mul16x16((uint16_t) (a < 0 ? -a : a), (uint16_t) (b < 0 ? -b : b));
+    return negative ? -(int32_t) p : (int32_t) p;
+}
+
+[[nodiscard]] uint16_t Math::div16x8(uint16_t a, uint8_t b) noexcept {
+    if (b < 2) return (b == 1) ? a : 0xffff;
+
+    // q = a * ceil(65536/b) / 65536 is exact or one too large
+    uint16_t r = (uint16_t) ((recip_table.hi[b] << 8) | recip_table.lo[b]);
+    uint16_t q = (uint16_t) (mul16x16(a, r) >> 16);
+    if (mul16x8(q, b) > a) q--;
+    return q;
+}
+
+[[nodiscard]] int8_t Math::sin(uint8_t angle) noexcept {
+    return trig_table.sin[angle];
+}
+
+[[nodiscard]] int8_t Math::cos(uint8_t angle) noexcept {
+    return trig_table.sin[(uint8_t) (angle + 64)];
+}
+
+[[nodiscard]] uint8_t Math::atan2(int16_t y, int16_t x) noexcept {
+    uint16_t ax = (uint16_t) (x < 0 ? -x : x);
+    uint16_t ay = (uint16_t) (y < 0 ? -y : y);
+    if (ax == 0 && ay == 0) return 0;
+
+    // reduce to 8 bit range
+    while ((ax | ay) & 0xff00) {
+        ax >>= 1;
+        ay >>= 1;
+    }
+
+    uint8_t angle;
+    if (ax >= ay) {
+        uint16_t ratio = div16x8((uint16_t) (ay << 8), (uint8_t) ax);
+        angle = trig_table.atan[ratio > 255 ? 255 : ratio];
+    } else {
+        uint16_t ratio = div16x8((uint16_t) (ax << 8), (uint8_t) ay);
+        angle = 64 - trig_table.atan[ratio > 255 ? 255 : ratio];
+    }
+
+    if (x < 0) angle = 128 - angle;
+    if (y < 0) angle = (uint8_t) -angle;
+
+    return angle;
+}
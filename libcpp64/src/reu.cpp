@@ -0,0 +1,130 @@
+#include <cstddef>
+#include <cstdint>
+
+#include "libcpp64/reu.h"
+
+using namespace sys;
+
+static const uint16_t reu_base = 0xdf00;
+
+static const uint8_t cmd_stash = 0x90;      // execute, no $ff00 trigger, c64 -> reu
+static const uint8_t cmd_fetch = 0x91;      // execute, no $ff00 trigger, reu -> c64
+static const uint8_t cmd_swap = 0x92;       // execute, no $ff00 trigger, swap
+
+static const uint8_t ctrl_none = 0x00;
+static const uint8_t ctrl_fix_reu = 0x40;   // reu address stays fixed (fill)
+
+static const uint32_t staging_address = 0x000000;   // bank 0
+static const uint32_t cache_start = 0x010000;       // bank 1 and up
+
+uint16_t Reu::bank_count{0};
+uint32_t Reu::cache_top{cache_start};
+uint8_t Reu::cache_count{0};
+Reu::cache_entry_t Reu::cache_entries[MaxCacheEntries]{};
+
+void Reu::init() noexcept {
+    bank_count = detect() ? detectBanks() : 0;
+    cacheClear();
+}
+
+bool Reu::detect() noexcept {
+    // registers read back what was written, open bus does not
+    static const uint8_t patterns[2][4] = { {0x55, 0xaa, 0x01, 0x80}, {0xaa, 0x55, 0xfe, 0x7f} };
+    for (const auto& pattern : patterns) {
+        for (uint8_t i=0; i<4; i++) memory(reu_base + 2 + i) = pattern[i];
+        for (uint8_t i=0; i<4; i++) {
+            if (memory(reu_base + 2 + i) != pattern[i]) return false;
+        }
+    }
+    return true;
+}
+
+uint16_t Reu::detectBanks() noexcept {
+    // banks wrap around at the end of the expansion memory, write the
+    // bank number to each bank top down, then read back bottom up
+    uint8_t value;
+    uint16_t bank = 256;
+    while (bank > 0) {
+        bank--;
+        value = (uint8_t) bank;
+        stash(&value, (uint32_t) bank << 16, 1);
+    }
+
+    for (bank = 0; bank < 256; bank++) {
+        fetch(&value, (uint32_t) bank << 16, 1);
+        if (value != (uint8_t) bank) break;
+    }
+
+    return bank;
+}
+
+void Reu::transfer(uint8_t command, uint16_t c64_address, uint32_t reu_address, uint16_t size, uint8_t control) noexcept {
+    memory(reu_base + 0x02) = (uint8_t) (c64_address & 0xff);
+    memory(reu_base + 0x03) = (uint8_t) (c64_address >> 8);
+    memory(reu_base + 0x04) = (uint8_t) (reu_address & 0xff);
+    memory(reu_base + 0x05) = (uint8_t) ((reu_address >> 8) & 0xff);
+    memory(reu_base + 0x06) = (uint8_t) ((reu_address >> 16) & 0xff);
+    memory(reu_base + 0x07) = (uint8_t) (size & 0xff);
+    memory(reu_base + 0x08) = (uint8_t) (size >> 8);
+    memory(reu_base + 0x09) = 0x00;     // no reu interrupts
+    memory(reu_base + 0x0a) = control;
+    memory(reu_base + 0x01) = command;  // cpu is halted until the transfer is done
+}
+
+void Reu::stash(const void* src, uint32_t reu_address, uint16_t size) noexcept {
+    transfer(cmd_stash, to_address(src), reu_address, size, ctrl_none);
+}
+
+void Reu::fetch(void* dest, uint32_t reu_address, uint16_t size) noexcept {
+    transfer(cmd_fetch, to_address(dest), reu_address, size, ctrl_none);
+}
+
+void Reu::copy(void* dest, const void* src, uint16_t size) noexcept {
+    // staged through bank 0, so overlapping ranges are fine
+    stash(src, staging_address, size);
+    fetch(dest, staging_address, size);
+}
+
+void Reu::fill(void* dest, uint8_t value, uint16_t size) noexcept {
+    stash(&value, staging_address, 1);
+    transfer(cmd_fetch, to_address(dest), staging_address, size, ctrl_fix_reu);
+}
+
+void Reu::swap(void* a, void* b, uint16_t size) noexcept {
+    stash(a, staging_address, size);
+    transfer(cmd_swap, to_address(b), staging_address, size, ctrl_none);
+    fetch(a, staging_address, size);
+}
+
+[[nodiscard]] uint8_t Reu::cacheStore(const void* src, uint16_t size) noexcept {
+    if (!isPresent() || 0 == size || cache_count >= MaxCacheEntries) return InvalidHandle;
+    if (cache_top + size > ((uint32_t) bank_count << 16)) return InvalidHandle;
+
+    auto& entry = cache_entries[cache_count];
+    entry.address = cache_top;
+    entry.size = size;
+
+    stash(src, cache_top, size);
+    cache_top += size;
+
+    return cache_count++;
+}
+
+[[nodiscard]] bool Reu::cacheLoad(uint8_t handle, void* dest) noexcept {
+    if (handle >= cache_count) return false;
+
+    const auto& entry = cache_entries[handle];
+    fetch(dest, entry.address, entry.size);
+
+    return true;
+}
+
+[[nodiscard]] uint16_t Reu::cacheSize(uint8_t handle) noexcept {
+    if (handle >= cache_count) return 0;
+    return cache_entries[handle].size;
+}
+
+void Reu::cacheClear() noexcept {
+    cache_top = cache_start;
+    cache_count = 0;
+}
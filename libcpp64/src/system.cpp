@@ -2,10 +2,17 @@
 #include <cstdint>
 
 #include "libcpp64/system.h"
+#include "libcpp64/reu.h"
 
+#if defined(LIBCPP64_HOST)
+sys::Host::Register sys::memory(const uint16_t address) {
+    return sys::Host::Register(address);
+}
+#else
 volatile uint8_t& sys::memory(const uint16_t address) {
     return *(reinterpret_cast<address_t>(address));
 }
+#endif
 
 void sys::set_bit(const uint16_t address, uint8_t bit, bool enabled) {
     if (enabled) {
@@ -21,17 +28,100 @@ void sys::set_bit(const uint16_t address, uint8_t bit, bool enabled) {
 
 using namespace sys;
 
+// optional, provided by the sidc generated music source
+extern const uint8_t music[] __attribute__((weak));
+extern const size_t music_size __attribute__((weak));
+
+#if !defined(LIBCPP64_HOST)
+
+// end of the linked program (LLVM-MOS linker script)
+extern char __heap_start;
+
+// overlay sections (link.ld), weak so programs linked without the
+// script (benchmarks) see empty overlays
+extern char __overlay_io_start __attribute__((weak));
+extern char __overlay_io_end __attribute__((weak));
+extern char __overlay_io_load_start __attribute__((weak));
+extern char __overlay_rom_start __attribute__((weak));
+extern char __overlay_rom_end __attribute__((weak));
+extern char __overlay_rom_load_start __attribute__((weak));
+
+// with the kernal mapped in, irqs go through the kernal entry ($ff48), which
+// pushes a, x, y before jumping via $0314. the trampoline pulls them again
+// and continues with the handler installed at $fffe in ram. aligned, as an
+// indirect jmp via $xxff reads the high byte from $xx00 on the 6510.
+extern "C" uint16_t kernal_irq_handler;
+alignas(2) uint16_t kernal_irq_handler{0};
+
+extern "C" void kernal_irq_trampoline(void);
+asm(
+    ".section .text.kernal_irq_trampoline,\"ax\",@progbits\n"
+    ".global kernal_irq_trampoline\n"
+    "kernal_irq_trampoline:\n"
+    "    pla\n"
+    "    tay\n"
+    "    pla\n"
+    "    tax\n"
+    "    pla\n"
+    "    jmp (kernal_irq_handler)\n"
+);
+
+// with overlays, irqs may hit while I/O is banked out. the wrapper saves $01,
+// banks in I/O and calls the handler with a fake interrupt frame, so the
+// handler's rti returns to the wrapper, which restores $01.
+extern "C" uint16_t banked_irq_handler;
+alignas(2) uint16_t banked_irq_handler{0};     // jmp (...), see kernal_irq_handler
+
+extern "C" void banked_irq_wrapper(void);
+asm(
+    ".section .text.banked_irq_wrapper,\"ax\",@progbits\n"
+    ".global banked_irq_wrapper\n"
+    "banked_irq_wrapper:\n"
+    "    pha\n"
+    "    lda $01\n"
+    "    pha\n"
+    "    lda #$35\n"
+    "    sta $01\n"
+    "    lda #mos16hi(1f)\n"
+    "    pha\n"
+    "    lda #mos16lo(1f)\n"
+    "    pha\n"
+    "    php\n"
+    "    jmp (banked_irq_handler)\n"
+    "1:\n"
+    "    pla\n"
+    "    sta $01\n"
+    "    pla\n"
+    "    rti\n"
+);
+
+#endif // LIBCPP64_HOST
+
 bool System::kernalAndBasicDisabled{false};
+bool System::bankedInterrupts{false};
+System::memory_range_t System::memory_ranges[MaxMemoryRanges]{};
+uint8_t System::memory_range_count{0};
 
 void System::init() noexcept {
+    initMemory();
+    initOverlays();
+    Reu::init();
 }
 
 void System::disableInterrupts() noexcept {
+#if defined(LIBCPP64_HOST)
+    Host::setInterruptsEnabled(false);
+#else
     asm volatile("sei");
+#endif
 }
 
 void System::enableInterrupts() noexcept {
+#if defined(LIBCPP64_HOST)
+    Host::setInterruptsEnabled(true);
+#else
     asm volatile("cli");
+#endif
 }
 
 void System::disableKernalAndBasic() noexcept {
@@ -43,10 +133,15 @@ void System::disableKernalAndBasic() noexcept {
     memory(0xdd0d) = 0x7f;              // kernal uses such an interrupt to flash the cursor and
                                         // scan the keyboard, so we better stop it.
 
+#if defined(LIBCPP64_HOST)
+    (void) (uint8_t) memory(0xdc0d);
+    (void) (uint8_t) memory(0xdd0d);
+#else
     asm volatile(                       // by reading this two registers we negate any pending CIA irqs.
         "lda $dc0d\n"                   // if we don't do this, a pending CIA irq might occur after
         "lda $dd0d\n"                   // we finish setting up our irq. we don't want that to happen.
     );
+#endif
 
     memory(0xd01a) = 0x0;               // clear VIC interrupt mask bits
     memory(0xd019) = 0x0;               // clear VIC interrupt request bits
@@ -69,34 +164,43 @@ void System::memMap(uint8_t bits) noexcept {
     memory(0x01) = memFlags;
 }
 
-// NOLINTNEXTLINE
-void System::copyRomCharset(uint8_t* dest, size_t src_offset, size_t char_count) noexcept {
-    const uint8_t* src = (const uint8_t*) (0xd000 +  src_offset);
+void System::beginKernalAccess() noexcept {
+    // temporarily map in the kernal rom to call kernal routines (e.g. disk i/o)
+    if (!kernalAndBasicDisabled) return;
 
+#if !defined(LIBCPP64_HOST)
     disableInterrupts();
-    uint8_t oldMemFlags = memory(0x01);
-    memory(0x1) = (oldMemFlags & 0xfb);  // enable access to Character ROM
-                                         // instead of mem-mapped I/O at $d000
+    kernal_irq_handler = *reinterpret_cast<volatile uint16_t*>(Constants::HARDWARE_IRQ);
+    *reinterpret_cast<volatile uint16_t*>(Constants::KERNAL_IRQ) = reinterpret_cast<uint16_t>(kernal_irq_trampoline);
+    memMap(0x6);                        // kernal ROM + I/O, no basic ROM
+    enableInterrupts();
+#endif
+}
 
-    if (0 == char_count) char_count = 256; // default size 2K
-    while (char_count) {
-        *(dest++) = *(src++); // 8 bytes per character
-        *(dest++) = *(src++);
-        *(dest++) = *(src++);
-        *(dest++) = *(src++);
-        *(dest++) = *(src++);
-        *(dest++) = *(src++);
-        *(dest++) = *(src++);
-        *(dest++) = *(src++);
-        char_count--;
+void System::setInterruptHandler(interrupt_handler_t fn) noexcept {
+#if defined(LIBCPP64_HOST)
+    Host::setInterruptHandler(fn);
+#else
+    if (!kernalAndBasicDisabled) {
+        *reinterpret_cast<interrupt_handler_t*>(Constants::KERNAL_IRQ) = fn;
+    } else if (bankedInterrupts) {
+        banked_irq_handler = reinterpret_cast<uint16_t>(fn);
+        *reinterpret_cast<volatile uint16_t*>(Constants::HARDWARE_IRQ) = reinterpret_cast<uint16_t>(banked_irq_wrapper);
+    } else {
+        *reinterpret_cast<interrupt_handler_t*>(Constants::HARDWARE_IRQ) = fn;
     }
+#endif
+}
 
-    memory(0x01) = oldMemFlags;
+void System::endKernalAccess() noexcept {
+    if (!kernalAndBasicDisabled) return;
 
+    disableInterrupts();
+    memMap(0x5);                        // NO kernel ROM + NO basic ROM + I/O
     enableInterrupts();
 }
 
-void System::copyCharset(const uint8_t* src, uint8_t* dest, size_t char_count) noexcept {
+static void copy_rom_chars(uint8_t* dest, const uint8_t* src, size_t char_count) {
     while (char_count) {
         *(dest++) = *(src++); // 8 bytes per character
         *(dest++) = *(src++);
@@ -110,6 +214,248 @@ void System::copyCharset(const uint8_t* src, uint8_t* dest, size_t char_count) n
     }
 }
 
+// NOLINTNEXTLINE
+void System::copyRomCharset(uint8_t* dest, size_t src_offset, size_t char_count) noexcept {
+    const uint8_t* src = to_ptr((uint16_t) (0xd000 + src_offset));
+
+    if (0 == char_count) char_count = 256; // default size 2K
+
+    // banked irqs map I/O in themselves, otherwise they must not
+    // run while the character ROM is visible instead of I/O
+    const bool irq_safe = bankedInterrupts && kernalAndBasicDisabled;
+
+    if (!irq_safe) disableInterrupts();
+    callBanked(MEMMAP_CHAR_ROM, copy_rom_chars, dest, src, char_count);
+    if (!irq_safe) enableInterrupts();
+}
+
+void System::copyCharset(const uint8_t* src, uint8_t* dest, size_t char_count) noexcept {
+    copy(dest, src, (uint16_t) (char_count * 8)); // 8 bytes per character
+}
+
+void System::copy(void* dest, const void* src, uint16_t size) noexcept {
+    if (Reu::isPresent() && size >= Reu::MinTransferSize) {
+        Reu::copy(dest, src, size);
+    } else {
+        memmove(dest, src, size);
+    }
+}
+
+void System::fill(void* dest, uint8_t value, uint16_t size) noexcept {
+    if (Reu::isPresent() && size >= Reu::MinTransferSize) {
+        Reu::fill(dest, value, size);
+    } else {
+        memset(dest, value, size);
+    }
+}
+
+void System::swap(void* a, void* b, uint16_t size) noexcept {
+    if (Reu::isPresent() && size >= Reu::MinTransferSize) {
+        Reu::swap(a, b, size);
+        return;
+    }
+
+    uint8_t* pa = (uint8_t*) a;
+    uint8_t* pb = (uint8_t*) b;
+    while (size--) {
+        uint8_t t = *pa;
+        *(pa++) = *pb;
+        *(pb++) = t;
+    }
+}
+
+void System::initMemory() noexcept {
+    // $0801-__heap_start  program
+    // $a000-$bfff         ram under basic rom
+    // $c000-$cfff         ram, soft stack at the top
+    // $d000-$dfff         i/o (not managed), overlays
+    // $e000-$fff9         ram under kernal rom, hardware vectors above
+
+    memory_range_count = 0;
+
+#if defined(LIBCPP64_HOST)
+    uint16_t program_end = Host::ProgramEnd;
+#else
+    uint16_t program_end = reinterpret_cast<uint16_t>(&__heap_start);
+#endif
+    if (program_end < 0xa000) addMemoryRange(program_end, 0xa000, false);
+    addMemoryRange(0xa000, 0xc000, true);
+    addMemoryRange(0xc000, 0xd000 - SoftStackSize, false);
+    addMemoryRange(0xe000, 0xfffa, true);
+
+    if (&music_size != nullptr) {
+        (void) reserveMemory(to_address(music), (uint16_t) music_size);
+    }
+}
+
+void System::initOverlays() noexcept {
+#if !defined(LIBCPP64_HOST)
+    uint16_t io_size = (uint16_t) (&__overlay_io_end - &__overlay_io_start);
+    uint16_t rom_size = (uint16_t) (&__overlay_rom_end - &__overlay_rom_start);
+    if (0 == io_size && 0 == rom_size) return;
+
+    // copy from the load area with all ram visible
+    disableInterrupts();
+    uint8_t saved = memory(0x01);
+    memMap(MEMMAP_RAM);
+    memcpy(&__overlay_io_start, &__overlay_io_load_start, io_size);
+    memcpy(&__overlay_rom_start, &__overlay_rom_load_start, rom_size);
+    memory(0x01) = saved;
+    enableInterrupts();
+
+    if (0 != rom_size) {
+        (void) reserveMemory(reinterpret_cast<uint16_t>(&__overlay_rom_start), rom_size);
+    }
+
+    // the load area is free now
+    uint16_t load_start = reinterpret_cast<uint16_t>(&__overlay_io_load_start);
+    uint16_t load_end = reinterpret_cast<uint16_t>(&__overlay_rom_load_start) + rom_size;
+    addMemoryRange(load_start, load_end, load_start >= 0xa000);
+
+    bankedInterrupts = (0 != io_size);
+#endif
+}
+
+void System::addMemoryRange(uint16_t start, uint16_t end, bool under_rom) noexcept {
+    if (memory_range_count >= MaxMemoryRanges) return;
+    auto& range = memory_ranges[memory_range_count++];
+    range.start = start;
+    range.end = end;
+    range.under_rom = under_rom;
+}
+
+bool System::carveRange(uint8_t index, uint16_t start, uint16_t end) noexcept {
+    auto& range = memory_ranges[index];
+
+    if (start == range.start && end == range.end) {
+        memory_range_count--;
+        for (uint8_t i=index; i<memory_range_count; i++) {
+            memory_ranges[i] = memory_ranges[i+1];
+        }
+    } else if (start == range.start) {
+        range.start = end;
+    } else if (end == range.end) {
+        range.end = start;
+    } else {
+        if (memory_range_count >= MaxMemoryRanges) return false;
+        addMemoryRange(end, range.end, range.under_rom);
+        range.end = start;
+    }
+
+    return true;
+}
+
+uint8_t* System::allocateRange(uint16_t size, uint16_t align, uint16_t lo, uint16_t hi, bool allow_under_rom, uint16_t avoid) noexcept {
+    if (size == 0 || align == 0) return nullptr;
+
+    const uint16_t align_mask = align - 1;
+
+    for (uint8_t i=0; i<memory_range_count; i++) {
+        const auto& range = memory_ranges[i];
+        if (range.under_rom && !allow_under_rom) continue;
+
+        uint16_t start = (range.start > lo) ? range.start : lo;
+        uint16_t end = (range.end < hi) ? range.end : hi;
+        if (start >= end) continue;
+
+        start = (start + align_mask) & ~align_mask;
+        if (start < range.start) continue; // wrapped
+
+        // skip the 4K block to be avoided (character rom seen by the vic)
+        if (avoid != 0x0 && start < avoid + 0x1000 && (start >= avoid || (uint16_t) (avoid - start) < size)) {
+            start = (avoid + 0x1000 + align_mask) & ~align_mask;
+        }
+
+        if (start >= end || (uint16_t) (end - start) < size) continue;
+
+        if (!carveRange(i, start, start + size)) return nullptr;
+        return to_ptr(start);
+    }
+
+    return nullptr;
+}
+
+[[nodiscard]] uint8_t* System::allocate(uint16_t size, uint16_t align) noexcept {
+    return allocateRange(size, align, 0x0000, 0xffff, kernalAndBasicDisabled, 0x0);
+}
+
+[[nodiscard]] uint8_t* System::allocateVic(uint16_t size, uint16_t align, uint8_t bank) noexcept {
+    // the vic always reads ram (also under the roms), except the character
+    // rom shadow at $1000-$1fff in bank 0 and $9000-$9fff in bank 2
+    bank &= 0x3;
+    uint16_t lo = bank * 0x4000;
+    uint16_t hi = (bank == 3) ? 0xffff : lo + 0x4000;
+    uint16_t avoid = (bank == 0 || bank == 2) ? lo + 0x1000 : 0x0;
+    return allocateRange(size, align, lo, hi, true, avoid);
+}
+
+[[nodiscard]] bool System::reserveMemory(uint16_t start, uint16_t size) noexcept {
+    uint16_t end = start + size;
+    for (uint8_t i=0; i<memory_range_count; i++) {
+        const auto& range = memory_ranges[i];
+        if (start >= range.start && end <= range.end && end >= start) {
+            return carveRange(i, start, end);
+        }
+    }
+    return false; // overlaps already used memory
+}
+
+[[nodiscard]] uint16_t System::getFreeMemory() noexcept {
+    uint16_t free = 0;
+    for (uint8_t i=0; i<memory_range_count; i++) {
+        const auto& range = memory_ranges[i];
+        if (range.under_rom && !kernalAndBasicDisabled) continue;
+        free += range.end - range.start;
+    }
+    return free;
+}
+
+void System::paintStacks() noexcept {
+    // fill the unused parts of both stacks, stackStats() finds the
+    // lowest address that was overwritten since
+#if defined(LIBCPP64_HOST)
+    uint8_t sp = 0xff;
+    uint16_t soft_sp = SoftStackTop;
+#else
+    uint8_t sp;
+    uint8_t soft_lo, soft_hi;
+    asm volatile("tsx" : "=x"(sp));
+    asm volatile(
+        "lda __rc0\n"
+        "ldy __rc1\n"
+        : "=a"(soft_lo), "=y"(soft_hi));
+    uint16_t soft_sp = (uint16_t) ((soft_hi << 8) | soft_lo);
+#endif
+
+    const uint16_t soft_bottom = SoftStackTop - SoftStackSize;
+    if (soft_sp > soft_bottom) memset(to_ptr(soft_bottom), StackPaint, (size_t) (soft_sp - soft_bottom));
+
+    // last, and without calls: a jsr would leave its return address
+    // behind. sp points to the next free byte.
+    uint8_t* hardware_stack = to_ptr(0x0100);
+    uint8_t i = sp;
+    do {
+        hardware_stack[i] = StackPaint;
+        asm volatile("" ::: "memory");  // keep the loop, no memset()
+    } while (i-- != 0);
+}
+
+[[nodiscard]] System::stack_stats_t System::stackStats() noexcept {
+    stack_stats_t stats;
+
+    const uint8_t* hardware_stack = to_ptr(0x0100);
+    uint16_t untouched = 0;
+    while (untouched < 0x100 && hardware_stack[untouched] == StackPaint) untouched++;
+    stats.hardware_max = (uint16_t) (0x100 - untouched);
+
+    const uint8_t* soft_stack = to_ptr(SoftStackTop - SoftStackSize);
+    untouched = 0;
+    while (untouched < SoftStackSize && soft_stack[untouched] == StackPaint) untouched++;
+    stats.soft_max = (uint16_t) (SoftStackSize - untouched);
+
+    return stats;
+}
+
 [[nodiscard]] constexpr uint8_t System::get_compiler_standard() noexcept {
     if (__cplusplus == 201703L) return 17;
     if (__cplusplus == 201402L) return 14;
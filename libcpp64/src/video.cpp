@@ -3,23 +3,27 @@
 #include <string.h>
 
 #include "libcpp64/video.h"
+#include "libcpp64/math.h"
+#include "libcpp64/compression.h"
+#include "libcpp64/trace.h"
 
 using namespace sys;
 
 static const bool raster_irq_debug{false};
-static const bool metrics_enabled{false};
 
 Video::metrics_t Video::metrics_{};
 volatile Video::stats_t Video::stats_{};
-volatile uint8_t stats_frame_counter{0};
+Video::SpriteCommandQueue Video::sprite_commands{};
+LIBCPP64_ZEROPAGE volatile uint8_t stats_frame_counter{0};
 volatile uint8_t Video::last_frame_counter_{0xff};
+uint16_t Video::loop_start_line_{0xffff};                // no main loop iteration started yet
 bool Video::raster_irq_enabled{false};
-uint16_t Video::row_addresses[25]{};
-uint16_t Video::col_addresses[25]{};
+LIBCPP64_HOT_TABLE uint16_t Video::row_addresses[25]{};
+LIBCPP64_HOT_TABLE uint16_t Video::col_addresses[25]{};
 
-Video::raster_step_t Video::raster_sequence[8]{};
-volatile uint8_t Video::raster_sequence_step{0};
-uint8_t Video::raster_sequence_step_count{0};
+LIBCPP64_ZEROPAGE_DATA Video::raster_step_t Video::raster_sequence[8]{};
+LIBCPP64_ZEROPAGE volatile uint8_t Video::raster_sequence_step{0};
+LIBCPP64_ZEROPAGE uint8_t Video::raster_sequence_step_count{0};
 
 uint16_t Video::vic_base    = 0x0;
 uint16_t Video::screen_base = 0x400;
@@ -27,10 +31,19 @@ uint16_t Video::char_base   = 0x1000;
 uint16_t Video::bitmap_base = 0x2000;
 uint16_t Video::color_base  = 0xd800;
 uint16_t Video::sprite_base = 0x400 + 0x03f8;
+uint16_t Video::sprite_data = 0x0;
 
 void Video::init() noexcept {
 
     uint8_t acc=0x0;
+#if defined(LIBCPP64_HOST)
+    uint8_t line, next;
+    do {
+        line = memory(0xd012);
+        while (line == (next = memory(0xd012))) {}
+    } while ((int8_t) (line - next) < 0);
+    acc = line;
+#else
     asm volatile (
         "pha\n"
         "w0: lda $d012\n"
@@ -41,6 +54,7 @@ void Video::init() noexcept {
         : "=a" (acc)
         :
     );
+#endif
     metrics_.num_raster_lines = 256 + acc + 1;
 
     if (metrics_.num_raster_lines > 300) {
@@ -83,9 +97,39 @@ void Video::setBank(uint8_t bank) noexcept {
     sprite_base = screen_base + 0x03f8;
 
     setScreenPtrs();
+}
+
+bool Video::loadSprites() noexcept {
+    auto data = System::allocateVic((uint16_t) sprites_size, 64, (uint8_t) (vic_base >> 14));
+    if (nullptr == data) return false;
+
+    System::copy(data, (const void*) sprites, (uint16_t) sprites_size);
+    sprite_data = to_address(data);
+
+    return true;
+}
 
-    memcpy((void*) vic_base, (const void*) sprites, sprites_size);
+bool Video::loadSprites(const uint8_t* packed) noexcept {
+    auto size = Compression::getUnpackedSize(packed);
+    auto data = System::allocateVic(size, 64, (uint8_t) (vic_base >> 14));
+    if (nullptr == data) return false;
+
+    Compression::unpack(packed, (uint8_t*) data);
+    sprite_data = to_address(data);
+
+    return true;
+}
+
+[[nodiscard]] uint8_t Video::allocateScreenBase() noexcept {
+    auto ptr = System::allocateVic(0x400, 0x400, (uint8_t) (vic_base >> 14));
+    if (nullptr == ptr) return 0xff;
+    return (uint8_t) ((to_address(ptr) - vic_base) >> 10);
+}
 
+[[nodiscard]] uint8_t Video::allocateCharacterBase() noexcept {
+    auto ptr = System::allocateVic(0x800, 0x800, (uint8_t) (vic_base >> 14));
+    if (nullptr == ptr) return 0xff;
+    return (uint8_t) ((to_address(ptr) - vic_base) >> 11);
 }
 
 void Video::setScreenPtrs() noexcept {
@@ -171,11 +215,7 @@ void Video::enableRasterSequence() noexcept {
     uint16_t rasterLineStop = (raster_sequence_step_count > 0) ? raster_sequence[0].line : metrics_.num_raster_lines - 1;
     setRasterIrqLine(rasterLineStop);
 
-    interrupt_handler_t* irq_address = reinterpret_cast<interrupt_handler_t*>(
-        System::isKernalAndBasicDisabled() ? Constants::HARDWARE_IRQ : Constants::KERNAL_IRQ
-    );
-
-    *irq_address = onRasterInterrupt;
+    System::setInterruptHandler(onRasterInterrupt);
 
     System::enableInterrupts();         // clear interrupt flag, allowing the CPU to respond to interrupt requests
 
@@ -191,11 +231,7 @@ void Video::enableRasterIrq(interrupt_handler_t fn, uint16_t raster_line) noexce
 
     setRasterIrqLine(raster_line);
 
-    interrupt_handler_t* irq_address = reinterpret_cast<interrupt_handler_t*>(
-        System::isKernalAndBasicDisabled() ? Constants::HARDWARE_IRQ : Constants::KERNAL_IRQ
-    );
-
-    *irq_address = fn;
+    System::setInterruptHandler(fn);
 
     System::enableInterrupts();         // clear interrupt flag, allowing the CPU to respond to interrupt requests
 
@@ -226,9 +262,13 @@ void Video::addRasterSequenceStep(uint16_t line, interrupt_handler_t fn) noexcep
 __attribute__((interrupt_norecurse))
 void Video::onRasterInterrupt() noexcept {
 
+#if !defined(LIBCPP64_HOST)
     if constexpr (raster_irq_debug) {
         asm ( "inc $d020\n" );
     }
+#endif
+
+    Trace::event8(Trace::EventIrqBegin, raster_sequence_step);
 
     const auto& entry = raster_sequence[raster_sequence_step];
     entry.fn();
@@ -240,9 +280,7 @@ void Video::onRasterInterrupt() noexcept {
 
     if (raster_sequence_step == 0) {
         stats_frame_counter = stats_frame_counter + 1;
-        if constexpr (metrics_enabled) {
-            updateMetrics();
-        }
+        updateMetrics();
     }
 
     if (raster_sequence_step_count > 1) {
@@ -256,11 +294,15 @@ void Video::onRasterInterrupt() noexcept {
 
     }
 
+#if !defined(LIBCPP64_HOST)
     if constexpr (raster_irq_debug) {
         asm ( "dec $d020\n" );
     }
+#endif
 
     memory(0xd019) = 0xff; // ACK irq, clear VIC irq flag
+
+    Trace::event(Trace::EventIrqEnd);
 }
 
 void Video::updateMetrics() noexcept {
@@ -279,26 +321,56 @@ void Video::updateMetrics() noexcept {
     stats_.time_millis = stats_.time_millis + stats_.time_delta;
     if (stats_.time_millis >= 1000) {
         stats_.time_seconds = stats_.time_seconds+ 1;
-        stats_.time_millis = stats_.time_millis + 1000;
+        stats_.time_millis = stats_.time_millis - 1000;
     }
 }
 
 void Video::waitNextFrame() noexcept {
 
+    Trace::event(Trace::EventWaitBegin);
+
+    const uint16_t line = getRasterLine();
+
     if (raster_irq_enabled) {
-        while (last_frame_counter_ == stats_frame_counter) {}
+        // frames counted by the irq while the main loop was running
+        accountFrame((uint8_t) (stats_frame_counter - last_frame_counter_), line);
+
+        while (last_frame_counter_ == stats_frame_counter) {
+#if defined(LIBCPP64_HOST)
+            Host::advanceRaster(1);     // the raster moves on while the cpu waits
+#endif
+        }
         last_frame_counter_ = stats_frame_counter;
+        loop_start_line_ = getRasterLine();
+        Trace::event(Trace::EventWaitEnd);
         return;
     }
 
-    uint16_t line = getRasterLine();
+    // without the irq, frames passing unnoticed can't be counted
+    accountFrame(0, line);
+
     if (line >= 240) { while (getRasterLine() > 80) {}; }
     while (getRasterLine() < 240) {};
 
     stats_frame_counter = stats_frame_counter + 1;
-    if constexpr (metrics_enabled) {
-        updateMetrics();
-    }
+    updateMetrics();
+    loop_start_line_ = getRasterLine();
+    Trace::event(Trace::EventWaitEnd);
+}
+
+void Video::accountFrame(uint8_t frames_elapsed, uint16_t line) noexcept {
+    if (loop_start_line_ == 0xffff) return; // first call
+
+    stats_.frames_processed = stats_.frames_processed + 1;
+    if (frames_elapsed > 0) stats_.frames_dropped = stats_.frames_dropped + frames_elapsed;
+
+    if (frames_elapsed > 200) frames_elapsed = 200; // fits 16 bits
+    uint16_t lines = (uint16_t) (line - loop_start_line_);
+    if (line < loop_start_line_) lines = (uint16_t) (lines + metrics_.num_raster_lines);
+    lines = (uint16_t) (lines + frames_elapsed * metrics_.num_raster_lines);
+
+    stats_.loop_lines = lines;
+    if (lines > stats_.loop_lines_max) stats_.loop_lines_max = lines;
 }
 
 void Video::waitLines(uint16_t lines) noexcept {
@@ -310,15 +382,15 @@ void Video::waitLines(uint16_t lines) noexcept {
 }
 
 void Video::clear(uint8_t c) noexcept {
-    __memset((char*) ((address_t)(screen_base)), c, 1000);
+    System::fill(to_ptr(screen_base), c, 1000);
 }
 
 void Video::fill(uint8_t c, size_t ofs, size_t count) noexcept {
-    __memset((char*) ((address_t)(screen_base + ofs)), c, count);
+    System::fill(to_ptr((uint16_t) (screen_base + ofs)), c, (uint16_t) count);
 }
 
 void Video::fillColor(uint8_t c, size_t ofs, size_t count) noexcept {
-    __memset((char*) ((address_t)(color_base + ofs)), c, count);
+    System::fill(to_ptr((uint16_t) (color_base + ofs)), c, (uint16_t) count);
 }
 
 void Video::setTextCommonColors(uint8_t colorA, uint8_t colorB) noexcept {
@@ -365,8 +437,9 @@ void Video::printNumber(uint8_t x, uint8_t y, uint8_t n) noexcept {
     uint16_t addr  = row_addresses[y] + x;
     uint8_t digit = 3;
     while (digit > 0 && n > 0) {
-        memory(addr+digit - 1) = 0x30 + (n%10);
-        n /= 10;
+        uint8_t q = Math::div10(n);
+        memory(addr+digit - 1) = 0x30 + (n - (q << 3) - (q << 1));
+        n = q;
         digit--;
     }
 
@@ -418,8 +491,8 @@ void Video::setSpriteMode(uint8_t sprite, bool multicolor) noexcept {
 }
 
 uint8_t Video::getSpriteAddress(const uint8_t* data) noexcept {
-    if (nullptr == data) return (uint8_t) 0;
-    uint8_t block = (uint8_t) ((reinterpret_cast<uint16_t>(data) - vic_base) / 64);
+    if (nullptr == data) return (uint8_t) ((sprite_data - vic_base) / 64);
+    uint8_t block = (uint8_t) ((to_address(data) - vic_base) / 64);
     return block;
 }
 
@@ -434,7 +507,7 @@ void Video::setSpriteData(uint8_t sprite, const uint8_t* data) noexcept {
 void Video::setSpritePos(uint8_t sprite, uint16_t x, uint16_t y) noexcept {
     static uint16_t addr;
     addr = 0xd000 + (sprite << 1);
-    *(reinterpret_cast<uint16_t*>(addr)) = ((y&0xff)<<8)|(x&0xff);
+    *(reinterpret_cast<uint16_t*>(to_ptr(addr))) = ((y&0xff)<<8)|(x&0xff);
     set_bit(0xd010, sprite, (x&0xff00)!=0x0);
 }
 
@@ -446,3 +519,17 @@ void Video::setSpriteCommonColors(uint8_t colorA, uint8_t colorB) noexcept {
     memory(0xd025) = colorA;
     memory(0xd026) = colorB;
 }
+
+[[nodiscard]] bool Video::postSpriteCommand(const sprite_command_t& command) noexcept {
+    // producer: main loop
+    return sprite_commands.push(command);
+}
+
+void Video::processSpriteCommands() noexcept {
+    // consumer: raster step, applies queued sprite updates without tearing
+    sprite_command_t command;
+    while (sprite_commands.pop(command)) {
+        setSpritePos(command.sprite, command.x, command.y);
+        setSpriteAddress(command.sprite, command.block);
+    }
+}
@@ -0,0 +1,201 @@
+//
+// Host build tests (ctest), see CMakeLists.txt
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#include <sys>
+
+using namespace sys;
+
+// music player stand-in: a shadowed tune writing a new pattern every update
+extern "C" uint8_t audio_sid_shadow[25];
+extern const bool music_shadowed = true;
+static uint8_t music_frame = 0;
+
+extern "C" void update_audio(void) {
+    music_frame++;
+    for (uint8_t reg=0; reg<25; reg++) audio_sid_shadow[reg] = (uint8_t) (music_frame + reg);
+}
+
+static int failures = 0;
+
+#define CHECK(cond) check((cond), #cond, __FILE__, __LINE__)
+
+static void check(bool ok, const char* expr, const char* file, int line) {
+    if (ok) return;
+    printf("%s:%d: CHECK(%s) failed\n", file, line, expr);
+    failures++;
+}
+
+static bool sidMatchesShadow(uint8_t first, uint8_t last) {
+    for (uint8_t reg=first; reg<=last; reg++) {
+        if (Host::getSidRegister(reg) != audio_sid_shadow[reg]) return false;
+    }
+    return true;
+}
+
+static void testFirstAccess() {
+    // hooks are installed on first use, regardless of static initialization order
+    CHECK(Host::read(0xdc01) == 0xff);  // cia1: no key pressed
+    CHECK(Host::read(0xdf00) == 0xff);  // no reu
+}
+
+static int raster_irqs = 0;
+static void onRasterIrq() { raster_irqs++; }
+
+static void testRasterIrq() {
+    Host::reset();
+    Host::setInterruptHandler(onRasterIrq);
+    Host::write(0xd012, 100);
+    Host::write(0xd01a, 0x01);
+
+    Host::advanceRaster(99);
+    CHECK(raster_irqs == 0);
+    Host::advanceRaster(1);
+    CHECK(raster_irqs == 1);
+    CHECK(Host::getRasterLine() == 100);
+    CHECK((Host::read(0xd019) & 0x81) == 0x81);
+
+    Host::write(0xd019, 0xff);          // acknowledge
+    CHECK(Host::read(0xd019) == 0x00);
+
+    Host::runFrame();
+    CHECK(raster_irqs == 2);
+
+    Host::write(0xd011, 0x9b);          // raster compare line 256 + 44
+    Host::write(0xd012, 44);
+    Host::advanceRaster(200);
+    CHECK(raster_irqs == 3);
+    CHECK(Host::getRasterLine() == 300);
+}
+
+static int step_a = 0;
+static int step_b = 0;
+static void onStepA() { step_a++; }
+static void onStepB() { step_b++; }
+
+static void testRasterSequence() {
+    Host::reset();
+    System::init();
+    Video::init();
+    Video::addRasterSequenceStep(50, onStepA);
+    Video::addRasterSequenceStep(200, onStepB);
+    Video::enableRasterSequence();
+
+    for (int frame=0; frame<4; frame++) Host::runFrame();
+    CHECK(step_a == 4);
+    CHECK(step_b == 4);
+}
+
+static void testKeyboard() {
+    Host::reset();
+    Keyboard::init();
+
+    uint8_t event;
+    Host::setKey(Keyboard::KEY_A, true);
+    Keyboard::scan();
+    CHECK(!Keyboard::pollEvent(event)); // debounced: needs two scans
+    Keyboard::scan();
+    CHECK(Keyboard::pollEvent(event) && event == Keyboard::KEY_A);
+    Keyboard::scan();
+    CHECK(!Keyboard::pollEvent(event)); // held, no repeated edge
+    CHECK(Keyboard::isKeyDown(Keyboard::KEY_A));
+
+    Host::setKey(Keyboard::KEY_A, false);
+    Keyboard::scan();
+    Keyboard::scan();
+    CHECK(Keyboard::pollEvent(event) && event == (Keyboard::KEY_A | Keyboard::EVENT_KEY_UP));
+    CHECK(!Keyboard::pollEvent(event));
+
+    Host::setJoystick(1, Keyboard::JOY_FIRE | Keyboard::JOY_LEFT);  // cia port a, joystick 2
+    Keyboard::scan();
+    CHECK(Keyboard::getJoystick(2) == (Keyboard::JOY_FIRE | Keyboard::JOY_LEFT));
+    CHECK(Keyboard::getJoystick(1) == 0);
+    CHECK(!Keyboard::pollEvent(event)); // joystick is not a key
+}
+
+static void testNoReu() {
+    Host::reset();
+    Reu::init();
+    CHECK(!Reu::isPresent());
+
+    auto src = to_ptr(0x2000);
+    auto dest = to_ptr(0x3000);
+    for (uint16_t i=0; i<300; i++) src[i] = (uint8_t) i;
+    System::copy(dest, src, 300);
+    CHECK(dest[0] == 0 && dest[255] == 255 && dest[299] == (uint8_t) 299);
+}
+
+static void testAudioFlush() {
+    Host::reset();
+    Audio::init();
+
+    Audio::update();
+    CHECK(sidMatchesShadow(0x00, 0x18));
+
+    static const uint8_t effect[] = {
+        Audio::FX_ADSR, 0x00, 0xf0,
+        Audio::FX_FREQ, 0x34, 0x12,
+        Audio::FX_CTRL, 0x21,
+        Audio::FX_WAIT, 10,
+        Audio::FX_END
+    };
+
+    // effect owns voice 3, voices 1 and 2 keep playing the music
+    CHECK(Audio::playEffect(effect));
+    Audio::update();
+    CHECK(Audio::isEffectPlaying());
+    CHECK(sidMatchesShadow(0x00, 0x0d));
+    CHECK(Host::getSidRegister(0x0e) == 0x34 && Host::getSidRegister(0x0f) == 0x12);
+    CHECK(Host::getSidRegister(0x12) == 0x21);
+    CHECK(sidMatchesShadow(0x15, 0x18));
+
+    // voice change stops the effect, all voices go back to the music
+    Audio::setEffectVoice(0);
+    Audio::update();
+    CHECK(!Audio::isEffectPlaying());
+    CHECK(sidMatchesShadow(0x00, 0x18));
+
+    // effect on voice 1
+    CHECK(Audio::playEffect(effect));
+    Audio::update();
+    CHECK(Host::getSidRegister(0x00) == 0x34 && Host::getSidRegister(0x04) == 0x21);
+    CHECK(sidMatchesShadow(0x07, 0x18));
+    Audio::stopEffect();
+    Audio::update();
+    CHECK(!Audio::isEffectPlaying());
+    CHECK(sidMatchesShadow(0x00, 0x18));
+
+    // stop without a running effect leaves the music alone
+    Audio::stopEffect();
+    Audio::update();
+    CHECK(!Audio::isEffectPlaying());
+    CHECK(sidMatchesShadow(0x00, 0x18));
+
+    // effects disabled (irq doesn't run Audio::update)
+    Audio::setEffectsEnabled(false);
+    CHECK(!Audio::playEffect(effect));
+    Audio::update();
+    CHECK(!Audio::isEffectPlaying());
+    Audio::setEffectsEnabled(true);
+}
+
+int main() {
+    testFirstAccess();
+    testRasterIrq();
+    testRasterSequence();
+    testKeyboard();
+    testNoReu();
+    testAudioFlush();
+
+    if (failures > 0) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+
+    printf("all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,152 @@
+// *****************************************************************************
+// SID file data
+// Name: On a sanction from CIA
+// Author: Cadaver
+// (C) Covert Bitops 2005
+// @generated by sidc
+// *****************************************************************************
+
+#include <cstddef>
+#include <cstdint>
+
+extern const size_t music_size = 0x08ec;
+extern const bool music_shadowed = true;
+
+asm (
+  ".section .music,\"a\",@progbits\n"
+  ".global music\n"
+  "music:\n"
+  "  .byte 0x4c,0xba,0x50,0x4c,0xbe,0x50,0xb9,0x04,0x55,0x4c,0x13,0x50,0xa8,0xa9,0x00,0x9d,0xca,0x53,0x98,0x9d,0xa1\n"
+  "  .byte 0x53,0xbd,0x90,0x53,0x9d,0xa0,0x53,0x60,0x9d,0xe5,0x53,0x60,0x9d,0xa4,0x53,0x60,0x30,0x0a,0x8d,0xb7,0x53\n"
+  "  .byte 0x8d,0xbe,0x53,0x8d,0xc5,0x53,0x60,0x29,0x7f,0x9d,0xb7,0x53,0x60,0xde,0xcb,0x53,0x4c,0x9c,0x52,0xf0,0xfb\n"
+  "  .byte 0xbd,0xcb,0x53,0xd0,0xf3,0xa9,0x00,0x85,0xff,0xbd,0xca,0x53,0x30,0x09,0xd9,0xa9,0x55,0x90,0x05,0xf0,0x02\n"
+  "  .byte 0x49,0xff,0x18,0x69,0x02,0x9d,0xca,0x53,0x4a,0x90,0x2e,0xb0,0x43,0x98,0xf0,0x50,0xb9,0xa9,0x55,0x85,0xff\n"
+  "  .byte 0xbd,0xa0,0x53,0xc9,0x02,0x90,0x1d,0xf0,0x32,0xbc,0xb9,0x53,0xbd,0xdf,0x53,0xf9,0xea,0x53,0x48,0xbd,0xe0\n"
+  "  .byte 0x53,0xf9,0x3c,0x54,0xa8,0x68,0xb0,0x17,0x65,0xfe,0x98,0x65,0xff,0x10,0x27,0xbd,0xdf,0x53,0x65,0xfe,0x9d\n"
+  "  .byte 0xdf,0x53,0xbd,0xe0,0x53,0x65,0xff,0x4c,0x99,0x52,0xe5,0xfe,0x98,0xe5,0xff,0x30,0x10,0xbd,0xdf,0x53,0xe5\n"
+  "  .byte 0xfe,0x9d,0xdf,0x53,0xbd,0xe0,0x53,0xe5,0xff,0x4c,0x99,0x52,0xbc,0xb9,0x53,0x4c,0x8b,0x52,0x8d,0xcc,0x50\n"
+  "  .byte 0x60,0xa2,0x18,0xbd,0xdf,0x53\n"
+  "  .byte 0x9d\n"
+  "  .word audio_sid_shadow+0x00\n"
+  "  .byte 0xca,0x10,0xf7,0xa2,0x00,0xa0,0x00,0x30,0x30,0x8a,0xa2,0x29,0x9d,0x8b,0x53,0xca,0x10,0xfa,0x8d,0xf4,0x53\n"
+  "  .byte 0x8d,0x4e,0x51,0x8d,0x00,0x51,0x8e,0xcc,0x50,0xaa,0x20,0xef,0x50,0xa2,0x07,0x20,0xef,0x50,0xa2,0x0e,0xa9\n"
+  "  .byte 0x05,0x9d,0xb7,0x53,0xa9,0x01,0x9d,0xb8,0x53,0x9d,0xba,0x53,0x4c,0x6c,0x53,0xa0,0x00,0xf0,0x45,0xa9,0x00\n"
+  "  .byte 0xd0,0x23,0xb9,0x8c,0x55,0xf0,0x12,0x10,0x19,0x0a,0x8d,0x53,0x51,0xb9,0x9a,0x55,0x8d,0x4e,0x51,0xb9,0x8d\n"
+  "  .byte 0x55,0xd0,0x1f,0xc8,0xb9,0x9a,0x55,0x8d,0x49,0x51,0x4c,0x39,0x51,0x8d,0x04,0x51,0xb9,0x9a,0x55,0x18,0x6d\n"
+  "  .byte 0x49,0x51,0x8d,0x49,0x51,0xce,0x04,0x51,0xd0,0x11,0xb9,0x8d,0x55,0xc9,0xff,0xc8,0x98,0x90,0x03,0xb9,0x9a\n"
+  "  .byte 0x55,0x8d,0x00,0x51,0xa9,0x00,0x8d,0xf5,0x53,0xa9,0x00,0x8d,0xf6,0x53,0xa9,0x00,0x09,0x0f,0x8d,0xf7,0x53\n"
+  "  .byte 0x20,0x63,0x51,0xa2,0x07,0x20,0x63,0x51,0xa2,0x0e,0xde,0xb8,0x53,0xf0,0x1c,0x10,0x06,0xbd,0xb7,0x53,0x9d\n"
+  "  .byte 0xb8,0x53,0x4c,0x35,0x52,0xe9,0xd0,0xfe,0x8d,0x53,0xdd,0x8d,0x53,0xd0,0x4c,0xa9,0x00,0x9d,0x8d,0x53,0xf0\n"
+  "  .byte 0x40,0xbc,0x90,0x53,0xb9,0x76,0x53,0x8d,0x2a,0x52,0x8d,0x33,0x52,0xbd,0x8e,0x53,0xd0,0x34,0xbc,0xb5,0x53\n"
+  "  .byte 0xb9,0x9c,0x54,0x85,0xfe,0xb9,0x9f,0x54,0x85,0xff,0xbc,0x8b,0x53,0xb1,0xfe,0xc9,0xff,0x90,0x06,0xc8,0xb1\n"
+  "  .byte 0xfe,0xa8,0xb1,0xfe,0xc9,0xe0,0x90,0x08,0xe9,0xf0,0x9d,0x8c,0x53,0xc8,0xb1,0xfe,0xc9,0xd0,0xb0,0xb2,0x9d\n"
+  "  .byte 0xb6,0x53,0xc8,0x98,0x9d,0x8b,0x53,0xbc,0xba,0x53,0xbd,0xa2,0x53,0xf0,0x5e,0x38,0xe9,0x60,0x9d,0xb9,0x53\n"
+  "  .byte 0xa9,0x00,0x9d,0xa0,0x53,0x9d,0xa2,0x53,0xb9,0x0f,0x55,0x9d,0xcb,0x53,0xb9,0x04,0x55,0x9d,0xa1,0x53,0xbd\n"
+  "  .byte 0x90,0x53,0xc9,0x03,0xf0,0x3d,0xa9,0x09,0x9d,0xa4,0x53,0xfe,0xbb,0x53,0xb9,0xee,0x54,0xf0,0x08,0x9d,0xa5\n"
+  "  .byte 0x53,0xa9,0x00,0x9d,0xa6,0x53,0xb9,0xf9,0x54,0xf0,0x08,0x8d,0x00,0x51,0xa9,0x00,0x8d,0x04,0x51,0xb9,0xe3\n"
+  "  .byte 0x54,0x9d,0xa3,0x53,0xb9,0xd8,0x54,0x9d,0xe5,0x53,0xb9,0xcd,0x54,0x9d,0xe4,0x53,0xbd,0x91,0x53,0x20,0x06\n"
+  "  .byte 0x50,0x4c,0x6c,0x53,0xbd,0x91,0x53,0x20,0x06,0x50,0xbc,0xa3,0x53,0xf0,0x30,0xb9,0x1a,0x55,0xc9,0x10,0xb0\n"
+  "  .byte 0x0a,0xdd,0xcc,0x53,0xf0,0x0a,0xfe,0xcc,0x53,0xd0,0x1f,0xe9,0x10,0x9d,0xa4,0x53,0xb9,0x1b,0x55,0xc9,0xff\n"
+  "  .byte 0xc8,0x98,0x90,0x04,0x18,0xb9,0x3b,0x55,0x9d,0xa3,0x53,0xa9,0x00,0x9d,0xcc,0x53,0xb9,0x3a,0x55,0xd0,0x19\n"
+  "  .byte 0xbd,0xb8,0x53,0xf0,0x30,0xbc,0xa0,0x53,0xb9,0x86,0x53,0x8d,0x81,0x52,0xbc,0xa1,0x53,0xb9,0xb3,0x55,0x85\n"
+  "  .byte 0xfe,0x4c,0x3d,0x50,0x10,0x05,0x7d,0xb9,0x53,0x29,0x7f,0xa8,0xa9,0x00,0x9d,0xca,0x53,0xb9,0xea,0x53,0x9d\n"
+  "  .byte 0xdf,0x53,0xb9,0x3c,0x54,0x9d,0xe0,0x53,0xbd,0xb8,0x53,0xc9,0x02,0xf0,0x4e,0xbc,0xa5,0x53,0xf0,0x46,0x1d\n"
+  "  .byte 0x8e,0x53,0xf0,0x41,0xbd,0xa6,0x53,0xd0,0x14,0xb9,0x5c,0x55,0x10,0x0c,0x9d,0xe2,0x53,0xb9,0x74,0x55,0x9d\n"
+  "  .byte 0xe1,0x53,0x4c,0xdf,0x52,0x9d,0xa6,0x53,0xb9,0x74,0x55,0x18,0x10,0x03,0xde,0xe2,0x53,0x7d,0xe1,0x53,0x9d\n"
+  "  .byte 0xe1,0x53,0x90,0x03,0xfe,0xe2,0x53,0xde,0xa6,0x53,0xd0,0x0f,0xb9,0x5d,0x55,0xc9,0xff,0xc8,0x98,0x90,0x03\n"
+  "  .byte 0xb9,0x74,0x55,0x9d,0xa5,0x53,0x4c,0x6c,0x53,0xbc,0xb6,0x53,0xb9,0xa2,0x54,0x85,0xfe,0xb9,0xb8,0x54,0x85\n"
+  "  .byte 0xff,0xbc,0x8e,0x53,0xb1,0xfe,0xc9,0x40,0x90,0x18,0xc9,0x60,0x90,0x1e,0xc9,0xc0,0x90,0x2e,0xbd,0x8f,0x53\n"
+  "  .byte 0xd0,0x02,0xb1,0xfe,0x69,0x00,0x9d,0x8f,0x53,0xf0,0x46,0xd0,0x4d,0x9d,0xba,0x53,0xc8,0xb1,0xfe,0xc9,0x60\n"
+  "  .byte 0xb0,0x14,0xc9,0x50,0x29,0x0f,0x9d,0x90,0x53,0xf0,0x06,0xc8,0xb1,0xfe,0x9d,0x91,0x53,0xb0,0x29,0xc8,0xb1\n"
+  "  .byte 0xfe,0xc9,0xbd,0x90,0x06,0xf0,0x20,0x09,0xf0,0xd0,0x19,0x7d,0x8c,0x53,0x9d,0xa2,0x53,0xbd,0x90,0x53,0xc9\n"
+  "  .byte 0x03,0xf0,0x0f,0xa9,0x00,0x9d,0xe5,0x53,0xa9,0x0f,0x9d,0xe4,0x53,0xa9,0xfe,0x9d,0xbb,0x53,0xc8,0xb1,0xfe\n"
+  "  .byte 0xf0,0x01,0x98,0x9d,0x8e,0x53,0xbd,0xa4,0x53,0x3d,0xbb,0x53,0x9d,0xe3,0x53,0x60,0x06,0x0c,0x0c,0x13,0x13\n"
+  "  .byte 0x1d,0x1d,0x21,0x25,0x25,0x25,0x25,0x25,0x25,0x25,0x25,0x3d,0x64,0x64,0x61,0x44,0x00,0x00,0x00,0x00,0x00\n"
+  "  .byte 0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00\n"
+  "  .byte 0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00\n"
+  "  .byte 0x01,0xfe,0x01,0x00,0x00,0x00,0x00,0x01,0xfe,0x02,0x00,0x00,0x00,0x00,0x01,0xfe,0x00,0x00,0x00,0x00,0x00\n"
+  "  .byte 0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00\n"
+  "  .byte 0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x71\n"
+  "  .byte 0x96,0xbe,0xe8,0x14,0x43,0x74,0xa9,0xe1,0x1c,0x5a,0x9c,0xe2,0x2d,0x7c,0xcf,0x28,0x85,0xe8,0x52,0xc1,0x37\n"
+  "  .byte 0xb4,0x39,0xc5,0x5a,0xf7,0x9e,0x4f,0x0a,0xd1,0xa3,0x82,0x6e,0x68,0x71,0x8a,0xb3,0xee,0x3c,0x9e,0x15,0xa2\n"
+  "  .byte 0x46,0x04,0xdc,0xd0,0xe2,0x14,0x67,0xdd,0x79,0x3c,0x29,0x44,0x8d,0x08,0xb8,0xa1,0xc5,0x28,0xcd,0xba,0xf1\n"
+  "  .byte 0x78,0x53,0x87,0x1a,0x10,0x71,0x42,0x89,0x4f,0x9b,0x74,0xe2,0xf0,0xa6,0x0e,0x33,0x20,0xff,0x02,0x02,0x02\n"
+  "  .byte 0x02,0x03,0x03,0x03,0x03,0x03,0x04,0x04,0x04,0x04,0x05,0x05,0x05,0x06,0x06,0x06,0x07,0x07,0x08,0x08,0x09\n"
+  "  .byte 0x09,0x0a,0x0a,0x0b,0x0c,0x0d,0x0d,0x0e,0x0f,0x10,0x11,0x12,0x13,0x14,0x15,0x17,0x18,0x1a,0x1b,0x1d,0x1f\n"
+  "  .byte 0x20,0x22,0x24,0x27,0x29,0x2b,0x2e,0x31,0x34,0x37,0x3a,0x3e,0x41,0x45,0x49,0x4e,0x52,0x57,0x5c,0x62,0x68\n"
+  "  .byte 0x6e,0x75,0x7c,0x83,0x8b,0x93,0x9c,0xa5,0xaf,0xb9,0xc4,0xd0,0xdd,0xea,0xf8,0xff,0xbd,0xd6,0x09,0x55,0x55\n"
+  "  .byte 0x56,0x2a,0x42,0x62,0x72,0xa4,0xc2,0xf4,0x49,0x60,0x7e,0x9f,0xad,0xd8,0xfd,0x18,0x3c,0x51,0x59,0xa3,0xbc\n"
+  "  .byte 0xe0,0xe8,0x56,0x56,0x56,0x56,0x56,0x56,0x56,0x57,0x57,0x57,0x57,0x57,0x57,0x57,0x58,0x58,0x58,0x58,0x58\n"
+  "  .byte 0x58,0x58,0x58,0x00,0x00,0x05,0x00,0x00,0x00,0x00,0x05,0x02,0x02,0xcc,0x8c,0xfa,0x6a,0xac,0xfa,0xfa,0xa8\n"
+  "  .byte 0x6a,0x5b,0x5b,0x8c,0x01,0x03,0x06,0x08,0x0a,0x0e,0x14,0x01,0x18,0x1d,0x01,0x01,0x06,0x10,0x00,0x0a,0x0d\n"
+  "  .byte 0x10,0x12,0x17,0x17,0x01,0x00,0x01,0x00,0x00,0x07,0x0b,0x00,0x00,0x00,0x00,0x00,0x01,0x02,0x00,0x00,0x02\n"
+  "  .byte 0x02,0x00,0x03,0x00,0x00,0x01,0x0f,0x07,0x00,0x00,0x07,0x07,0x00,0x07,0x00,0x00,0x0f,0x51,0xff,0x91,0x51\n"
+  "  .byte 0xff,0x31,0xff,0x27,0xff,0x91,0x51,0x51,0xff,0x91,0x51,0x51,0x91,0x51,0xff,0x51,0x31,0x30,0xff,0x51,0x02\n"
+  "  .byte 0x02,0x02,0xff,0x51,0x02,0x02,0x02,0xff,0x80,0x00,0x4f,0x80,0x00,0x80,0x00,0x80,0x00,0x4f,0x28,0x80,0x00\n"
+  "  .byte 0x4f,0x26,0x2c,0x50,0x80,0x00,0x80,0x8c,0x80,0x00,0x80,0x83,0x88,0x80,0x19,0x80,0x83,0x87,0x80,0x1e,0x80\n"
+  "  .byte 0x10,0x30,0x30,0xff,0x82,0x40,0x40,0xff,0x88,0x01,0xff,0x88,0x03,0xff,0x84,0xff,0x82,0x10,0x40,0x40,0xff\n"
+  "  .byte 0x8a,0xff,0x00,0x40,0x10,0xf0,0x03,0x00,0x08,0xf8,0x07,0x00,0x00,0x06,0x00,0x00,0x06,0x00,0x00,0x00,0x7f\n"
+  "  .byte 0xe0,0x20,0x14,0x00,0x14,0xb8,0x00,0x88,0x00,0x60,0xff,0xb8,0x00,0x02,0xff,0xb8,0x00,0x03,0xff,0xf4,0xf0\n"
+  "  .byte 0x14,0x40,0x01,0x00,0xf4,0xf0,0x00,0x03,0xf4,0xf0,0xe0,0x03,0x00,0x03,0x03,0x02,0x00,0x00,0x00,0x00,0x00\n"
+  "  .byte 0x01,0x00,0x20,0x10,0x40,0x40,0x20,0x80,0x50,0x10,0x00,0xf0,0x00,0x03,0x05,0x06,0x07,0xf0,0x08,0xee,0x08\n"
+  "  .byte 0xf0,0x0d,0xed,0x0d,0xf0,0x0b,0xed,0x0b,0x0f,0x0f,0x0f,0x09,0xd3,0xff,0x00,0xf0,0x01,0x04,0x04,0xee,0x04\n"
+  "  .byte 0x04,0xf3,0x04,0x04,0xf1,0x04,0x04,0xf3,0x04,0x04,0xf1,0x04,0x04,0xf3,0x04,0x04,0xf1,0x04,0x04,0xf0,0x09\n"
+  "  .byte 0x09,0xee,0x09,0xf5,0x09,0xf0,0x09,0x09,0xed,0x09,0x09,0xf0,0x09,0x09,0xed,0x09,0x09,0x10,0x12,0x13,0x14\n"
+  "  .byte 0x15,0xff,0x00,0xf0,0x02,0x02,0xf3,0x02,0x02,0x02,0xf0,0x0a,0x0a,0xee,0x0a,0xf5,0x0a,0xf0,0x0c,0x0c,0xed\n"
+  "  .byte 0x0c,0x0e,0xf0,0x0c,0x0c,0xed,0x0c,0x0e,0x11,0x11,0x11,0x0a,0xd3,0xff,0x00,0x01,0x4f,0x05,0x99,0x50,0xbe\n"
+  "  .byte 0xfb,0x9b,0xbd,0xbe,0xfb,0x94,0xf3,0xbe,0xfb,0x9a,0xbd,0xbe,0xfb,0x95,0xbd,0xbe,0xef,0x00,0x40,0xbe,0xfd\n"
+  "  .byte 0x01,0x9c,0xbd,0xbe,0xfb,0x97,0xbd,0xbe,0xef,0x97,0xbd,0xbe,0xfb,0x99,0xbd,0xbe,0xfb,0x41,0x04,0x9c,0x43\n"
+  "  .byte 0x04,0x9e,0xfe,0x50,0xf7,0xbe,0xbd,0x00,0x02,0x40,0x75,0xe5,0xbe,0xbd,0x75,0x43,0x00,0x74,0x40,0x73,0xe3\n"
+  "  .byte 0xbe,0xbd,0x00,0x01,0x40,0x99,0xbd,0xbe,0xbd,0x9c,0xbd,0xbe,0xbd,0x9b,0xbd,0xbe,0xbd,0x97,0xbd,0xbe,0xbd\n"
+  "  .byte 0x94,0xf3,0xbe,0xbd,0x97,0xbd,0xbe,0xbd,0x9a,0xbd,0xbe,0xbd,0x99,0xbd,0xbe,0xbd,0x95,0xbd,0xbe,0xbd,0x41\n"
+  "  .byte 0x04,0x9c,0x43,0x04,0x9e,0xfe,0x50,0xf7,0xbe,0xbd,0x00,0x03,0x4f,0x83,0x99,0x43,0x00,0x9b,0x9c,0x9b,0x99\n"
+  "  .byte 0x94,0x99,0x9b,0x9c,0x9b,0x99,0x94,0x99,0x9b,0x9c,0x9b,0x99,0x94,0x99,0x9b,0x9c,0x9b,0x99,0x94,0x00,0x01\n"
+  "  .byte 0x40,0x9c,0xbd,0xbe,0xbd,0x97,0xbd,0xbe,0xbd,0x9b,0xbd,0xbe,0xbd,0x9a,0xbd,0xbe,0xbd,0x99,0xf3,0xbe,0xbd\n"
+  "  .byte 0x9a,0xbd,0xbe,0xbd,0x95,0xbd,0xbe,0xbd,0x9c,0xbd,0xbe,0xbd,0x9f,0xbd,0xbe,0xbd,0x42,0x05,0x9f,0x43,0x04\n"
+  "  .byte 0x9d,0xfe,0x50,0xf7,0xbe,0xbd,0x00,0x01,0x41,0x04,0x9e,0x43,0x05,0x9f,0xfd,0x43,0x00,0x9e,0x9c,0x97,0x41\n"
+  "  .byte 0x04,0x9e,0x43,0x05,0x9f,0xbd,0x43,0x00,0x9e,0x9c,0x97,0x41,0x04,0x9e,0x43,0x05,0x9f,0xbd,0x43,0x00,0x9e\n"
+  "  .byte 0x9c,0x97,0x4f,0x83,0x9e,0x43,0x00,0x9f,0x9e,0x9f,0x9e,0x9f,0x40,0xa1,0x43,0x00,0xa3,0xa1,0xa3,0xa1,0xa3\n"
+  "  .byte 0x40,0xa4,0x43,0x00,0xa6,0xa4,0xa6,0xa4,0xa6,0x4f,0x85,0xa3,0x50,0xfc,0x43,0x00,0xa4,0x40,0xa1,0xf6,0xbe\n"
+  "  .byte 0xbd,0xa3,0xfd,0xa4,0xfd,0xa6,0xfd,0x00,0x01,0x41,0x06,0xa6,0x43,0x04,0xa8,0xfc,0x40,0xa3,0xe9,0xbe,0xbd\n"
+  "  .byte 0xa1,0xfb,0x9a,0xf8,0x56,0x8d,0x40,0xbe,0xf1,0x00,0x04,0x40,0x7c,0x51,0x07,0xfd,0x51,0x08,0xfd,0x51,0x07\n"
+  "  .byte 0xfd,0x51,0x08,0xfd,0x51,0x07,0xfd,0x51,0x08,0xfd,0x51,0x07,0xfe,0x40,0xa0,0x52,0x08,0xe6,0x00,0x07,0x4f\n"
+  "  .byte 0x06,0x99,0x40,0x94,0x9b,0x94,0x9c,0x9b,0x97,0x99,0x94,0x9b,0x94,0x9c,0x9b,0x97,0x99,0x94,0x9b,0x94,0x9c\n"
+  "  .byte 0x9b,0x97,0x99,0x94,0x9b,0x94,0xa0,0x9e,0x9c,0x00,0x05,0x40,0x75,0x75,0xbd,0xbe,0xf6,0x75,0xbd,0x75,0xbd\n"
+  "  .byte 0xbe,0xf7,0x00,0x08,0x40,0xa5,0xbd,0x56,0x3a,0x50,0xbe,0xbd,0xa7,0xbd,0x56,0x3a,0x50,0xbe,0xbd,0xa0,0xbd\n"
+  "  .byte 0x56,0x3a,0x50,0xf4,0xa5,0xbd,0x56,0x3a,0x50,0xbe,0xbd,0xa7,0xbd,0x56,0x3a,0x50,0xbe,0xbd,0xac,0xbd,0x56\n"
+  "  .byte 0x3a,0x50,0xf4,0x00,0x05,0x40,0x75,0xfe,0x02,0x75,0x06,0x75,0xfe,0x05,0x73,0xbd,0x75,0xbd,0x78,0x06,0x77\n"
+  "  .byte 0xbd,0x05,0x75,0xfe,0x02,0x75,0x06,0x75,0xfe,0x05,0x73,0xbd,0x75,0xbd,0x06,0x78,0x05,0x77,0x75,0x00,0x01\n"
+  "  .byte 0x40,0x81,0xfd,0x57,0x43,0x50,0xf9,0x43,0x09,0x8d,0xbd,0x50,0xf4,0x43,0x00,0x8f,0x50,0xf6,0x43,0x00,0x8b\n"
+  "  .byte 0x89,0x88,0x50,0xf4,0x00,0x05,0x40,0x75,0xfe,0x02,0x75,0x06,0x75,0xfe,0x05,0x73,0xbd,0x75,0xbd,0x78,0x06\n"
+  "  .byte 0x77,0xbd,0x05,0x75,0xfe,0x02,0x75,0x06,0x75,0xfe,0x05,0x73,0xbd,0x75,0xbd,0x06,0x78,0x77,0x75,0x00,0x09\n"
+  "  .byte 0x40,0x8d,0xf9,0xbe,0xfb,0x0a,0x8b,0xf9,0xbe,0xfb,0x90,0xf9,0xbe,0xfb,0x09,0x92,0xf9,0xbe,0xfb,0x00,0x04\n"
+  "  .byte 0x4f,0x06,0x8d,0x51,0x05,0xca,0x00,0x05,0x40,0x71,0xbe,0xbd,0x71,0x06,0x71,0xbe,0xbd,0x05,0x71,0xbe,0x71\n"
+  "  .byte 0xbe,0x71,0x06,0x71,0xbe,0x05,0x73,0xbe,0xbd,0x73,0x06,0x73,0xbe,0xbd,0x05,0x73,0xbe,0x73,0xbe,0x73,0x06\n"
+  "  .byte 0x74,0x05,0x76,0x78,0xbe,0xbd,0x78,0x06,0x78,0xbe,0xbd,0x05,0x78,0xbe,0x78,0xbe,0x78,0x06,0x78,0xbe,0x05\n"
+  "  .byte 0x76,0xbe,0xbd,0x76,0x06,0x76,0xbe,0xbd,0x05,0x76,0xbe,0x76,0xbe,0x76,0x06,0x76,0xbe,0x00,0x0b,0x4f,0x06\n"
+  "  .byte 0xa8,0x50,0xf6,0x52,0x04,0xbd,0x43,0x06,0xa6,0xfe,0x50,0xf6,0xa3,0xf5,0x43,0x00,0xa6,0xa3,0xa1,0x50,0xf4\n"
+  "  .byte 0x00,0x08,0x40,0x9c,0xf5,0x52,0x04,0xbd,0x43,0x00,0x9a,0x50,0xfb,0x95,0xfd,0x43,0x00,0x97,0x9a,0x95,0x41\n"
+  "  .byte 0x04,0x95,0x43,0x04,0x97,0xfe,0x50,0xfb,0x52,0x05,0xfd,0x0b,0x40,0x78,0xf3,0x00,0x04,0x46,0x6c,0xb1,0x52\n"
+  "  .byte 0x04,0xca,0x00,0x51,0x08,0xc9,0x00\n"
+);
+
+asm (
+  ".global music_load_address\n"
+  ".set music_load_address, 0x5000\n"
+  ".global music_init_address\n"
+  ".set music_init_address, 0x5000\n"
+  ".global music_play_address\n"
+  ".set music_play_address, 0x5003\n"
+
+  ".text\n"
+  ".global init_audio\n"
+  "init_audio:\n"
+  "  lda #$00\n"
+  "  ldx #0\n"
+  "  ldy #0\n"
+  "  jmp music_init_address\n"
+
+  ".global update_audio\n"
+  "update_audio:\n"
+  "  jmp music_play_address\n"
+);
@@ -0,0 +1,20 @@
+// *****************************************************************************
+// Sprite bank: sprites.spd
+// @generated by sprite64
+// *****************************************************************************
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+extern const uint8_t sprite_bank[];          // packed, see Video::loadSprites(packed)
+extern const size_t sprite_bank_size;
+
+const uint8_t sprite_bank_frame_count = 6;
+
+// sprite blocks relative to the first block of the bank (constexpr, can be checked with static_assert)
+constexpr uint8_t sprite_bank_roll_right[] = { 0, 1, 2, 3, 4, 5 };
+const uint8_t sprite_bank_roll_right_length = 6;
+constexpr uint8_t sprite_bank_roll_left[] = { 5, 4, 3, 2, 1, 0 };
+const uint8_t sprite_bank_roll_left_length = 6;
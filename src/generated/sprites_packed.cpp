@@ -0,0 +1,27 @@
+// *****************************************************************************
+// Packed data: sprites.spd
+// @generated by pack64
+// *****************************************************************************
+
+#include <cstddef>
+#include <cstdint>
+
+extern const uint8_t sprites_packed[] = {
+  0xc0,0x01,0xc0,0x02,0xa5,0x00,0x0a,0xa5,0x40,0x0a,0xa5,0x40,0x2a,0xa5,0x50,0x03,0x00,0x52,0x95,0x50,0xaa,0x95,0x54,0x03,
+  0x00,0x92,0x5a,0x95,0x54,0x55,0x6a,0x94,0x55,0x6a,0xa8,0x03,0x00,0x50,0x15,0x6a,0xa0,0x15,0xaa,0x03,0x00,0xf2,0x22,0x05,
+  0xaa,0x80,0x05,0xaa,0x80,0x01,0xaa,0x00,0x00,0x00,0x00,0x82,0x02,0x95,0x00,0x0a,0x55,0x40,0x0a,0x55,0x40,0x2a,0x55,0x60,
+  0x2a,0x55,0x60,0x29,0x55,0x60,0xa9,0x55,0x68,0xa9,0x55,0xa8,0xa9,0x55,0xa8,0x59,0x55,0xa8,0x56,0xaa,0xa8,0x56,0xaa,0x54,
+  0x03,0x00,0xf2,0x02,0x1a,0xaa,0x50,0x1a,0xaa,0x50,0x2a,0xaa,0x50,0x0a,0xaa,0x40,0x0a,0xa9,0x40,0x02,0xa5,0x40,0x00,0xc1,
+  0x56,0x00,0x09,0x56,0x80,0x09,0x56,0x80,0x29,0x56,0xa0,0x25,0x03,0x00,0x32,0x95,0x5a,0xa8,0x03,0x00,0x92,0x69,0x5a,0xa8,
+  0x6a,0xaa,0xa8,0x6a,0xa9,0x54,0x03,0x00,0x03,0xa1,0x00,0x20,0xa5,0x50,0xb0,0x00,0x41,0x95,0x40,0x02,0x95,0x40,0x00,0xc0,
+  0x01,0x5a,0x00,0x05,0x5a,0x80,0x05,0x5a,0x80,0x15,0x5a,0xa0,0x03,0x00,0x25,0x6a,0xa0,0xb1,0x00,0x65,0xa5,0x6a,0xa8,0xaa,
+  0x95,0x68,0xcf,0x00,0x50,0x2a,0x95,0x50,0x2a,0x55,0x03,0x00,0x02,0xb0,0x00,0x22,0x02,0x55,0x40,0x00,0x22,0x6a,0x00,0xd0,
+  0x00,0xc2,0x15,0xaa,0x90,0x15,0xaa,0x90,0x16,0xaa,0x90,0x56,0xaa,0x94,0xb1,0x00,0x62,0xa6,0xaa,0x54,0xa9,0x55,0x54,0xcc,
+  0x00,0xf2,0x05,0xa9,0x55,0xa8,0x25,0x55,0xa0,0x25,0x55,0xa0,0x15,0x55,0xa0,0x05,0x55,0x80,0x05,0x56,0x80,0x01,0x5a,0x40,
+  0x00,0xc1,0xa9,0x00,0x06,0xa9,0x40,0x06,0xa9,0x40,0x16,0xa9,0x50,0x1a,0x03,0x00,0x32,0x6a,0xa5,0x54,0x03,0x00,0x92,0x96,
+  0xa5,0x54,0x95,0x55,0x54,0x95,0x56,0xa8,0x03,0x00,0x03,0xa1,0x00,0x20,0x5a,0xa0,0xb0,0x00,0x42,0x6a,0x80,0x01,0x6a,0x40,
+  0x00,0xb2,0x55,0x00,0x05,0x55,0x40,0x05,0x55,0x40,0x15,0x55,0x50,0x03,0x00,0x3f,0x55,0x55,0x54,0x03,0x00,0x02,0x05,0x21,
+  0x00,0x02,0x30,0x00,0x12,0x01,0xc0,0x00
+};
+
+extern const size_t sprites_packed_size = 344;
@@ -16,11 +16,21 @@ raster_irq_debug    = 0         // enable/disable border color debugging
 
 .text
 
+//
+// Patch point: global label on the operand of the next instruction,
+// patched from C++ (see libcpp64/patch.h)
+//
+.macro patch_point name
+    .global \name
+    \name = . + 1
+.endm
+
 //
 // Set raster irq handler and irq raster line
 // (does not support 9th bit)
 //
-.macro set_raster_irq fn, line
+.macro set_raster_irq fn, line, patch
+    patch_point \patch
     lda #\line
     sta $d012
     lda #<\fn
@@ -37,6 +47,22 @@ raster_irq_debug    = 0         // enable/disable border color debugging
     sta $d019
 .endm
 
+//
+// Copy the sid register shadow to the sid if the tune
+// was converted with 'sidc -s' (see Audio::update). Sound effects
+// are not updated here, they are disabled with Audio::setEffectsEnabled.
+//
+.macro flush_sid_shadow
+    lda music_shadowed
+    beq 2f
+    ldx #24
+1:  lda audio_sid_shadow,x
+    sta $d400,x
+    dex
+    bpl 1b
+2:
+.endm
+
 //
 // Set border color
 //
@@ -56,9 +82,10 @@ on_raster_irq_0:
         set_border_color 1
     .endif
 
-    set_raster_irq on_raster_irq_1, raster_irq_line_1 // set next irq handler
+    set_raster_irq on_raster_irq_1, raster_irq_line_1, raster_patch_line_1 // set next irq handler
 
-    lda #200    // hard-coded high-res text mode
+    patch_point raster_patch_hires_mode
+    lda #200                                                // high-res text mode, patched at init
     sta $d016
 
     clear_raster_irq
@@ -86,9 +113,10 @@ on_raster_irq_1:
     tya
     pha
 
-    set_raster_irq on_raster_irq_2, raster_irq_line_2 // set next irq handler
+    set_raster_irq on_raster_irq_2, raster_irq_line_2, raster_patch_line_2 // set next irq handler
 
     jsr update_audio
+    flush_sid_shadow
 
     clear_raster_irq
 
@@ -115,9 +143,10 @@ on_raster_irq_2:
         set_border_color 1
     .endif
 
-    set_raster_irq on_raster_irq_0, raster_irq_line_0       // set next irq handler
+    set_raster_irq on_raster_irq_0, raster_irq_line_0, raster_patch_line_0 // set next irq handler
 
-    lda #216                                                // hard-coded multi-color mode
+    patch_point raster_patch_multicolor_mode
+    lda #216                                                // multi-color mode, patched at init
     sta $d016
 
     inc stats_frame_counter                                 // increment 8-bit frame counter
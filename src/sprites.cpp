@@ -0,0 +1,89 @@
+#include <cstddef>
+#include <cstdint>
+
+#include <sys>
+using namespace sys;
+
+#include "sprites.h"
+
+namespace SpriteBatch {
+
+    Sprite sprites[sprite_count];
+
+    void init() {
+
+        Video::setSpriteCommonColors(sprites_col_multi1, sprites_col_multi2);
+
+        static LIBCPP64_HOT_CONST_TABLE const uint8_t sprite_colors[] = {2,6,2,11,2,4,2,9};
+
+        uint8_t block_index = Video::getSpriteAddress();
+
+        for (auto i = 0; i < sprite_count; i++) {
+            auto& sprite = sprites[i];
+
+            sprite.id = i;
+
+            auto col = sprite_colors[i];
+            sprite.set(true, block_index, col, true);
+
+            sprite.x = (int16_t) (Constants::Width / 3 + i * 300);
+            sprite.vx = (int16_t) (25 + i);
+            sprite.xdir = 0;
+
+            sprite.y = (int16_t) (- i * 100);
+            sprite.vy = (int16_t) (- i * 30);
+
+            sprite.animation_delay = 1 + i/2;
+
+            sprite.updatePos();
+            sprite.updateAnimation();
+        }
+
+    }
+
+    __attribute__((noinline)) void update() {
+
+        for (auto i = 0; i < sprite_count; i++) {
+            auto& sprite = sprites[i];
+
+            if (sprite.animation_counter >= sprite.animation_delay) {
+                sprite.animation_counter -= sprite.animation_delay;
+                sprite.animation++;
+                if (sprite.animation == spriteFrameCount) sprite.animation = 0;
+
+            } else {
+                sprite.animation_counter++;
+            }
+
+
+            if (sprite.xdir == 0) {
+                sprite.x += sprite.vx;
+                if (sprite.x > spriteMaxX) {
+                    sprite.x = spriteMaxX;
+                    sprite.xdir = 1;
+                    sprite.animation = (uint8_t) (spriteFrameCount - 1 - sprite.animation); // same frame, other table
+                }
+            } else {
+                sprite.x -= sprite.vx;
+                if (sprite.x < spriteMinX) {
+                    sprite.x = spriteMinX;
+                    sprite.xdir = 0;
+                    sprite.animation = (uint8_t) (spriteFrameCount - 1 - sprite.animation);
+                }
+            }
+
+            sprite.y += sprite.vy;
+            if (sprite.y > spriteMaxY) {
+                sprite.y = spriteMaxY;
+                sprite.vy = -spriteMaxVY;
+            }
+
+            sprite.vy += 3;
+            if (sprite.vy > spriteMaxVY) sprite.vy = spriteMaxVY;
+
+            sprite.post();
+        }
+
+    }
+
+} // namespace
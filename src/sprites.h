@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <sys>
+
+#include "generated/sprite_bank.h"
+
+const int16_t spriteMinX = 192;
+const int16_t spriteMaxX = 2591;
+const int16_t spriteMaxY = 1775;
+const int16_t spriteMaxVY = 80;
+const uint8_t spriteFrameCount = sprite_bank_roll_right_length;
+
+// a sprite turning around keeps its frame: index i in roll_right shows
+// the same block as spriteFrameCount - 1 - i in roll_left
+constexpr bool rollTablesMirrored() {
+    if (sprite_bank_roll_left_length != spriteFrameCount) return false;
+    for (uint8_t i=0; i<spriteFrameCount; i++) {
+        if (sprite_bank_roll_left[i] != sprite_bank_roll_right[spriteFrameCount - 1 - i]) return false;
+    }
+    return true;
+}
+
+static_assert(rollTablesMirrored(), "roll_left must be roll_right reversed (see resources/sprites.json)");
+
+struct Sprite {
+
+    uint8_t id{0};
+    int16_t x{0};
+    int16_t y{0};
+    int16_t vx{0};
+    int16_t vy{0};
+    uint8_t xdir{0};
+    uint8_t address{0};
+    uint8_t animation{0};
+    uint8_t animation_delay{0};
+    uint8_t animation_counter{0};
+
+    Sprite()
+    {}
+
+    inline void set(uint8_t enabled, uint8_t address, uint8_t color, bool multicolor) {
+        this->address = address;
+        sys::Video::setSpriteAddress(id, address);
+        sys::Video::setSpriteEnabled(id, enabled);
+        sys::Video::setSpriteMode(id, multicolor);
+        sys::Video::setSpriteColor(id, color);
+    }
+
+    inline void updatePos() const {
+        if (x <= 0 || y <= 0) {
+            sys::Video::setSpritePos(id, 0, 0);
+            return;
+        }
+        sys::Video::setSpritePos(id, x>>3, y>>3);
+    }
+
+    inline uint8_t frameAddress() const {
+        auto frames = (xdir == 0) ? sprite_bank_roll_right : sprite_bank_roll_left;
+        return (uint8_t) (this->address + frames[animation]);
+    }
+
+    inline void updateAnimation() const {
+        sys::Video::setSpriteAddress(id, frameAddress());
+    }
+
+    inline void post() const {
+        // applied by the vertical blank raster step, so position and
+        // frame change together. set directly if the queue is full.
+        sys::Video::sprite_command_t command{id, frameAddress(), 0, 0};
+        if (x > 0 && y > 0) {
+            command.x = (uint16_t) (x>>3);
+            command.y = (uint8_t) (y>>3);
+        }
+        if (!sys::Video::postSpriteCommand(command)) {
+            updatePos();
+            updateAnimation();
+        }
+    }
+
+};
+
+namespace SpriteBatch {
+
+    const uint8_t sprite_count = 8;
+    extern Sprite sprites[sprite_count];
+
+    void init();
+    void update();
+
+} // namespace
@@ -0,0 +1,78 @@
+#include <cstddef>
+#include <cstdint>
+#include <string.h>
+
+#include <sys>
+using namespace sys;
+
+#include "starfield.h"
+
+namespace Starfield {
+
+    LIBCPP64_ZEROPAGE uint8_t star_x[num_stars];
+    LIBCPP64_ZEROPAGE uint8_t star_shift[num_stars];
+    LIBCPP64_ZEROPAGE uint8_t star_speed[num_stars];
+
+    const uint8_t star_char_base = (charset_size / 8); // use chars after custom charset
+    LIBCPP64_HOT_CONST_TABLE const uint8_t star_color[] = { 0xf, 0xc, 0x1 };
+
+    void init() {
+        // prepare charset
+        auto charset = (uint8_t*) Video::getCharacterBasePtr();
+        auto ptr = charset + (star_char_base << 3);
+        memset(ptr, 0x0, 72); ptr += 8; // make all 9 chars blank
+        for (int i=0; i<8; i++) { // now set pixel-wise sprite movement
+            *ptr = (1<<i);
+            ptr += 8;
+        }
+
+        // init stars
+        for (int i=0; i<num_stars; i++) {
+            star_x[i] = sys::rand() % 104; // 40+64
+            star_shift[i] = 0;
+            star_speed[i] = 1 + (i%3);
+        }
+
+        // init color buffer
+        uint8_t y = stars_y;
+        auto linePtr = Video::getColorPtr(y);
+        while (y < stars_yend) {
+            memset((void*) linePtr, star_color[y%3], 40);
+            linePtr += (size_t) (40 * step_size);
+            y += step_size;
+        }
+    }
+
+    __attribute__((noinline)) void update() {
+
+        static uint8_t y;
+        y = stars_y;
+
+        for (int i=0; i<num_stars; i++) {
+
+            if (star_x[i] >= 40) {
+                star_x[i]--;
+                y += step_size;
+                continue;
+            }
+
+            star_shift[i] += star_speed[i];
+            if (star_shift[i] >= 8) {
+                star_shift[i] -= 8;
+                Video::putc(star_x[i], y, star_char_base);
+                if (star_x[i] == 0) {
+                    star_x[i] = 40 + (sys::rand()>>2);
+                    y += step_size;
+                    continue;
+                } else {
+                    star_x[i]--;
+                }
+            }
+
+            Video::putc(star_x[i], y, star_char_base + 1 + star_shift[i]);
+            y += step_size;
+        }
+
+    }
+
+} // namespace
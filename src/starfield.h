@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <sys>
+
+extern const size_t charset_size;
+
+namespace Starfield {
+
+    const size_t num_stars = 10;
+    extern LIBCPP64_ZEROPAGE uint8_t star_x[num_stars];
+    extern LIBCPP64_ZEROPAGE uint8_t star_shift[num_stars];
+    extern LIBCPP64_ZEROPAGE uint8_t star_speed[num_stars];
+
+    extern const uint8_t star_char_base;
+    const uint8_t stars_y = 3;
+    const uint8_t step_size = 2;
+    const uint8_t stars_yend = 23;
+
+    void init();
+    void update();
+
+} // namespace
@@ -0,0 +1,186 @@
+//
+// Host build tests of the demo's sprite and starfield logic (ctest), see CMakeLists.txt
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#include <sys>
+
+#include "sprites.h"
+#include "starfield.h"
+
+using namespace sys;
+
+// resource stand-ins: sprite colors and a 64 character charset
+extern const unsigned char sprites_col_multi1 = 1;
+extern const unsigned char sprites_col_multi2 = 11;
+extern const size_t charset_size = 64 * 8;
+
+static int failures = 0;
+
+#define CHECK(cond) check((cond), #cond, __FILE__, __LINE__)
+
+static void check(bool ok, const char* expr, const char* file, int line) {
+    if (ok) return;
+    printf("%s:%d: CHECK(%s) failed\n", file, line, expr);
+    failures++;
+}
+
+static void initVideo() {
+    Video::processSpriteCommands();         // drop commands queued by earlier tests
+    Host::reset();
+    Video::init();
+    Video::setBank(2);
+    Video::setScreenBase(Video::allocateScreenBase());
+    Video::setCharacterBase(Video::allocateCharacterBase());
+}
+
+static uint8_t screenAt(uint8_t x, uint8_t y) {
+    return *(Video::getScreenPtr(y) + x);
+}
+
+static void testSpriteInit() {
+    initVideo();
+    SpriteBatch::init();
+
+    for (uint8_t i=0; i<SpriteBatch::sprite_count; i++) {
+        auto& sprite = SpriteBatch::sprites[i];
+        CHECK(sprite.id == i);
+        CHECK(sprite.xdir == 0 && sprite.animation == 0);
+        CHECK(sprite.frameAddress() == sprite.address + sprite_bank_roll_right[0]);
+    }
+    CHECK(Host::read(0xd025) == sprites_col_multi1 && Host::read(0xd026) == sprites_col_multi2);
+}
+
+static void testSpriteBounce() {
+    initVideo();
+    SpriteBatch::init();
+
+    auto& sprite = SpriteBatch::sprites[0];
+    sprite.x = spriteMaxX - 1;
+    sprite.y = 800;
+    sprite.vy = 0;
+    sprite.animation = 2;
+    sprite.animation_counter = 0;
+    sprite.animation_delay = 100;   // no frame step in this update
+    uint8_t frame = sprite.frameAddress();
+
+    SpriteBatch::update();
+    CHECK(sprite.x == spriteMaxX);
+    CHECK(sprite.xdir == 1);
+    CHECK(sprite.frameAddress() == frame); // same frame, other table
+    CHECK(sprite.y == 800 && sprite.vy == 3);
+
+    sprite.x = spriteMinX + 1;
+    SpriteBatch::update();
+    CHECK(sprite.x == spriteMinX);
+    CHECK(sprite.xdir == 0);
+    CHECK(sprite.frameAddress() == frame);
+}
+
+static void testSpriteGravity() {
+    initVideo();
+    SpriteBatch::init();
+
+    auto& sprite = SpriteBatch::sprites[1];
+    sprite.y = spriteMaxY - 10;
+    sprite.vy = spriteMaxVY;
+
+    SpriteBatch::update();
+    CHECK(sprite.y == spriteMaxY);
+    CHECK(sprite.vy == -spriteMaxVY + 3);
+
+    sprite.vy = spriteMaxVY;
+    sprite.y = 100;
+    SpriteBatch::update();
+    CHECK(sprite.vy == spriteMaxVY);        // capped
+}
+
+static void testSpriteAnimation() {
+    initVideo();
+    SpriteBatch::init();
+
+    auto& sprite = SpriteBatch::sprites[2];
+    sprite.animation = spriteFrameCount - 1;
+    sprite.animation_delay = 1;
+    sprite.animation_counter = 1;
+
+    SpriteBatch::update();
+    CHECK(sprite.animation == 0);           // wraps around
+    CHECK(sprite.animation_counter == 0);
+
+    SpriteBatch::update();
+    CHECK(sprite.animation == 0 && sprite.animation_counter == 1);
+}
+
+static void testSpriteCommands() {
+    initVideo();
+    SpriteBatch::init();
+
+    auto& sprite = SpriteBatch::sprites[0];
+    sprite.x = 800;
+    sprite.y = 800;
+    sprite.vx = 0;
+    sprite.vy = 0;                          // gravity applies after the move
+
+    SpriteBatch::update();
+    Video::processSpriteCommands();
+    CHECK(Host::read(0xd000) == (uint8_t) (800 >> 3));
+    CHECK(Host::read(0xd001) == (uint8_t) (800 >> 3));
+    CHECK(*(Video::getScreenBasePtr() + 0x3f8) == sprite.frameAddress());
+}
+
+static void testStarfieldInit() {
+    initVideo();
+    Starfield::init();
+
+    auto charset = Video::getCharacterBasePtr() + (Starfield::star_char_base << 3);
+    for (uint8_t row=0; row<8; row++) CHECK(charset[row] == 0x0);
+    for (uint8_t i=0; i<8; i++) CHECK(charset[(1 + i) * 8] == (1 << i));
+
+    for (uint8_t i=0; i<Starfield::num_stars; i++) {
+        CHECK(Starfield::star_x[i] < 104);
+        CHECK(Starfield::star_shift[i] == 0);
+        CHECK(Starfield::star_speed[i] >= 1 && Starfield::star_speed[i] <= 3);
+    }
+}
+
+static void testStarfieldUpdate() {
+    initVideo();
+    Starfield::init();
+
+    using namespace Starfield;
+    for (uint8_t i=0; i<num_stars; i++) star_x[i] = 50;     // off screen
+    star_x[0] = 10; star_shift[0] = 0; star_speed[0] = 3;   // row 3: moves within the char
+    star_x[1] = 10; star_shift[1] = 6; star_speed[1] = 3;   // row 5: moves to the next char
+
+    update();
+    CHECK(star_x[0] == 10 && star_shift[0] == 3);
+    CHECK(screenAt(10, stars_y) == star_char_base + 1 + 3);
+
+    CHECK(star_x[1] == 9 && star_shift[1] == 1);
+    CHECK(screenAt(10, stars_y + step_size) == star_char_base);         // blank
+    CHECK(screenAt(9, stars_y + step_size) == star_char_base + 1 + 1);
+
+    CHECK(star_x[2] == 49);                 // off screen stars move towards the screen
+}
+
+int main() {
+    testSpriteInit();
+    testSpriteBounce();
+    testSpriteGravity();
+    testSpriteAnimation();
+    testSpriteCommands();
+    testStarfieldInit();
+    testStarfieldUpdate();
+
+    if (failures > 0) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+
+    printf("all checks passed\n");
+    return 0;
+}
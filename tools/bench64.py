@@ -0,0 +1,712 @@
+#
+# bench64 - Headless cycle benchmarks for C64 programs
+# (C) Roland Schabenberger
+#
+
+import sys
+import os
+import os.path
+import getopt
+import json
+import struct
+from pathlib import Path
+
+from pack64 import get_sys_address
+
+MAX_LINE_LENGTH = 120
+
+CYCLES_PER_LINE = 63            # PAL
+RASTER_LINES = 312
+BADLINE_STALL = 40
+FIRST_BADLINE = 0x30
+LAST_BADLINE = 0xf7
+
+RETURN_ADDRESS = 0x0000         # calls return here (cpu port, never executed)
+MAX_CYCLES = 20000000
+DEFAULT_STACK = 0xd000          # llvm-mos soft stack (link.ld __stack)
+DEFAULT_RC_BASE = 0x02          # llvm-mos imaginary registers (link.ld __rc0)
+TRACE_PORTS = (0xd7fc, 0xd7fe)  # libcpp64/trace.h
+
+class CPU:
+    '''NMOS 6502, documented opcodes, cycle exact per instruction'''
+
+    def __init__(self):
+        self.mem = bytearray(65536)
+        self.a = self.x = self.y = 0
+        self.sp = 0xff
+        self.pc = 0
+        self.c = self.z = self.i = self.d = self.v = self.n = 0
+        self.cycles = 0
+        self.table = {}
+        self._build()
+
+    def rd(self, a): return self.mem[a & 0xffff]
+    def wr(self, a, v): self.mem[a & 0xffff] = v & 0xff
+    def rd16(self, a): return self.rd(a) | (self.rd(a + 1) << 8)
+    def rd16zp(self, a): return self.rd(a & 0xff) | (self.rd((a + 1) & 0xff) << 8)
+    def push(self, v): self.wr(0x100 | self.sp, v); self.sp = (self.sp - 1) & 0xff
+    def pull(self): self.sp = (self.sp + 1) & 0xff; return self.rd(0x100 | self.sp)
+    def nz(self, v): v &= 0xff; self.z = int(v == 0); self.n = v >> 7; return v
+
+    def getp(self, b=1):
+        return self.c | (self.z << 1) | (self.i << 2) | (self.d << 3) | (b << 4) | 0x20 | (self.v << 6) | (self.n << 7)
+
+    def setp(self, p):
+        self.c = p & 1; self.z = (p >> 1) & 1; self.i = (p >> 2) & 1; self.d = (p >> 3) & 1
+        self.v = (p >> 6) & 1; self.n = (p >> 7) & 1
+
+    # addressing modes return (address, page_crossed)
+    def m_imm(self): a = self.pc; self.pc += 1; return a, 0
+    def m_zp(self): a = self.rd(self.pc); self.pc += 1; return a, 0
+    def m_zpx(self): a = (self.rd(self.pc) + self.x) & 0xff; self.pc += 1; return a, 0
+    def m_zpy(self): a = (self.rd(self.pc) + self.y) & 0xff; self.pc += 1; return a, 0
+    def m_abs(self): a = self.rd16(self.pc); self.pc += 2; return a, 0
+
+    def m_abx(self):
+        b = self.rd16(self.pc); self.pc += 2; a = (b + self.x) & 0xffff
+        return a, int((a ^ b) > 0xff)
+
+    def m_aby(self):
+        b = self.rd16(self.pc); self.pc += 2; a = (b + self.y) & 0xffff
+        return a, int((a ^ b) > 0xff)
+
+    def m_izx(self):
+        z = (self.rd(self.pc) + self.x) & 0xff; self.pc += 1
+        return self.rd16zp(z), 0
+
+    def m_izy(self):
+        b = self.rd16zp(self.rd(self.pc)); self.pc += 1; a = (b + self.y) & 0xffff
+        return a, int((a ^ b) > 0xff)
+
+    def m_ind(self):
+        p = self.rd16(self.pc); self.pc += 2
+        return self.rd(p) | (self.rd((p & 0xff00) | ((p + 1) & 0xff)) << 8), 0
+
+    def adc(self, v):
+        if self.d:
+            lo = (self.a & 0x0f) + (v & 0x0f) + self.c
+            hi = (self.a >> 4) + (v >> 4)
+            if lo > 9: lo += 6; hi += 1
+            r = (self.a + v + self.c) & 0xff
+            self.z = int(r == 0)
+            self.n = (hi >> 3) & 1
+            self.v = int(((self.a ^ (hi << 4)) & ~(self.a ^ v) & 0x80) != 0)
+            if hi > 9: hi += 6
+            self.c = int(hi > 15)
+            self.a = ((hi << 4) | (lo & 0x0f)) & 0xff
+            return
+        r = self.a + v + self.c
+        self.v = int(((self.a ^ r) & (v ^ r) & 0x80) != 0)
+        self.c = int(r > 0xff)
+        self.a = self.nz(r)
+
+    def sbc(self, v):
+        if self.d:
+            r = self.a - v - (1 - self.c)
+            lo = (self.a & 0x0f) - (v & 0x0f) - (1 - self.c)
+            hi = (self.a >> 4) - (v >> 4)
+            if lo < 0: lo -= 6; hi -= 1
+            if hi < 0: hi -= 6
+            self.v = int(((self.a ^ v) & (self.a ^ r) & 0x80) != 0)
+            self.c = int(r >= 0)
+            self.nz(r)
+            self.a = ((hi << 4) | (lo & 0x0f)) & 0xff
+            return
+        r = self.a - v - (1 - self.c)
+        self.v = int(((self.a ^ v) & (self.a ^ r) & 0x80) != 0)
+        self.c = int(r >= 0)
+        self.a = self.nz(r)
+
+    def cmp(self, r, v): t = r - v; self.c = int(t >= 0); self.nz(t)
+
+    def _build(self):
+        t = self.table
+        modes = {"imm": self.m_imm, "zp": self.m_zp, "zpx": self.m_zpx, "zpy": self.m_zpy,
+                 "abs": self.m_abs, "abx": self.m_abx, "aby": self.m_aby, "izx": self.m_izx,
+                 "izy": self.m_izy}
+
+        def rop(code, mode, cyc, fn):
+            m = modes[mode]
+            def op():
+                a, x = m(); fn(self.rd(a)); return cyc + x
+            t[code] = op
+
+        def wop(code, mode, cyc, fn):
+            m = modes[mode]
+            def op():
+                a, _ = m(); self.wr(a, fn()); return cyc
+            t[code] = op
+
+        def mop(code, mode, cyc, fn):
+            m = modes[mode]
+            def op():
+                a, _ = m(); self.wr(a, fn(self.rd(a))); return cyc
+            t[code] = op
+
+        def lda(v): self.a = self.nz(v)
+        def ldx(v): self.x = self.nz(v)
+        def ldy(v): self.y = self.nz(v)
+        def ora(v): self.a = self.nz(self.a | v)
+        def and_(v): self.a = self.nz(self.a & v)
+        def eor(v): self.a = self.nz(self.a ^ v)
+        def bit(v): self.z = int((self.a & v) == 0); self.n = v >> 7; self.v = (v >> 6) & 1
+        def asl(v): self.c = v >> 7; return self.nz(v << 1)
+        def lsr(v): self.c = v & 1; return self.nz(v >> 1)
+        def rol(v): c = self.c; self.c = v >> 7; return self.nz((v << 1) | c)
+        def ror(v): c = self.c; self.c = v & 1; return self.nz((v >> 1) | (c << 7))
+        def inc(v): return self.nz(v + 1)
+        def dec(v): return self.nz(v - 1)
+
+        groups = [
+            (ora, {"imm":(0x09,2),"zp":(0x05,3),"zpx":(0x15,4),"abs":(0x0d,4),"abx":(0x1d,4),"aby":(0x19,4),"izx":(0x01,6),"izy":(0x11,5)}),
+            (and_, {"imm":(0x29,2),"zp":(0x25,3),"zpx":(0x35,4),"abs":(0x2d,4),"abx":(0x3d,4),"aby":(0x39,4),"izx":(0x21,6),"izy":(0x31,5)}),
+            (eor, {"imm":(0x49,2),"zp":(0x45,3),"zpx":(0x55,4),"abs":(0x4d,4),"abx":(0x5d,4),"aby":(0x59,4),"izx":(0x41,6),"izy":(0x51,5)}),
+            (self.adc, {"imm":(0x69,2),"zp":(0x65,3),"zpx":(0x75,4),"abs":(0x6d,4),"abx":(0x7d,4),"aby":(0x79,4),"izx":(0x61,6),"izy":(0x71,5)}),
+            (self.sbc, {"imm":(0xe9,2),"zp":(0xe5,3),"zpx":(0xf5,4),"abs":(0xed,4),"abx":(0xfd,4),"aby":(0xf9,4),"izx":(0xe1,6),"izy":(0xf1,5)}),
+            (lambda v: self.cmp(self.a, v), {"imm":(0xc9,2),"zp":(0xc5,3),"zpx":(0xd5,4),"abs":(0xcd,4),"abx":(0xdd,4),"aby":(0xd9,4),"izx":(0xc1,6),"izy":(0xd1,5)}),
+            (lambda v: self.cmp(self.x, v), {"imm":(0xe0,2),"zp":(0xe4,3),"abs":(0xec,4)}),
+            (lambda v: self.cmp(self.y, v), {"imm":(0xc0,2),"zp":(0xc4,3),"abs":(0xcc,4)}),
+            (lda, {"imm":(0xa9,2),"zp":(0xa5,3),"zpx":(0xb5,4),"abs":(0xad,4),"abx":(0xbd,4),"aby":(0xb9,4),"izx":(0xa1,6),"izy":(0xb1,5)}),
+            (ldx, {"imm":(0xa2,2),"zp":(0xa6,3),"zpy":(0xb6,4),"abs":(0xae,4),"aby":(0xbe,4)}),
+            (ldy, {"imm":(0xa0,2),"zp":(0xa4,3),"zpx":(0xb4,4),"abs":(0xac,4),"abx":(0xbc,4)}),
+            (bit, {"zp":(0x24,3),"abs":(0x2c,4)}),
+        ]
+        for fn, ms in groups:
+            for mode, (code, cyc) in ms.items(): rop(code, mode, cyc, fn)
+
+        for code, mode, cyc in ((0x85,"zp",3),(0x95,"zpx",4),(0x8d,"abs",4),(0x9d,"abx",5),(0x99,"aby",5),(0x81,"izx",6),(0x91,"izy",6)):
+            wop(code, mode, cyc, lambda: self.a)
+        for code, mode, cyc in ((0x86,"zp",3),(0x96,"zpy",4),(0x8e,"abs",4)):
+            wop(code, mode, cyc, lambda: self.x)
+        for code, mode, cyc in ((0x84,"zp",3),(0x94,"zpx",4),(0x8c,"abs",4)):
+            wop(code, mode, cyc, lambda: self.y)
+
+        for fn, base, acc in ((asl,0x00,0x0a),(rol,0x20,0x2a),(lsr,0x40,0x4a),(ror,0x60,0x6a)):
+            mop(base+0x06, "zp", 5, fn); mop(base+0x16, "zpx", 6, fn)
+            mop(base+0x0e, "abs", 6, fn); mop(base+0x1e, "abx", 7, fn)
+            def accop(fn=fn):
+                self.a = fn(self.a); return 2
+            t[acc] = accop
+        for fn, base in ((dec,0xc0),(inc,0xe0)):
+            mop(base+0x06, "zp", 5, fn); mop(base+0x16, "zpx", 6, fn)
+            mop(base+0x0e, "abs", 6, fn); mop(base+0x1e, "abx", 7, fn)
+
+        def branch(cond):
+            def op():
+                d = self.rd(self.pc); self.pc += 1
+                if not cond(): return 2
+                if d > 127: d -= 256
+                old = self.pc; self.pc = (self.pc + d) & 0xffff
+                return 3 + int((old ^ self.pc) > 0xff)
+            return op
+        t[0x10] = branch(lambda: not self.n); t[0x30] = branch(lambda: self.n)
+        t[0x50] = branch(lambda: not self.v); t[0x70] = branch(lambda: self.v)
+        t[0x90] = branch(lambda: not self.c); t[0xb0] = branch(lambda: self.c)
+        t[0xd0] = branch(lambda: not self.z); t[0xf0] = branch(lambda: self.z)
+
+        def imp(code, cyc, fn):
+            def op(): fn(); return cyc
+            t[code] = op
+        def set_(n, v): setattr(self, n, v)
+        imp(0x18, 2, lambda: set_("c", 0)); imp(0x38, 2, lambda: set_("c", 1))
+        imp(0x58, 2, lambda: set_("i", 0)); imp(0x78, 2, lambda: set_("i", 1))
+        imp(0xd8, 2, lambda: set_("d", 0)); imp(0xf8, 2, lambda: set_("d", 1))
+        imp(0xb8, 2, lambda: set_("v", 0)); imp(0xea, 2, lambda: None)
+        imp(0xaa, 2, lambda: set_("x", self.nz(self.a))); imp(0x8a, 2, lambda: set_("a", self.nz(self.x)))
+        imp(0xa8, 2, lambda: set_("y", self.nz(self.a))); imp(0x98, 2, lambda: set_("a", self.nz(self.y)))
+        imp(0xba, 2, lambda: set_("x", self.nz(self.sp))); imp(0x9a, 2, lambda: set_("sp", self.x))
+        imp(0xe8, 2, lambda: set_("x", self.nz(self.x + 1))); imp(0xca, 2, lambda: set_("x", self.nz(self.x - 1)))
+        imp(0xc8, 2, lambda: set_("y", self.nz(self.y + 1))); imp(0x88, 2, lambda: set_("y", self.nz(self.y - 1)))
+        imp(0x48, 3, lambda: self.push(self.a)); imp(0x08, 3, lambda: self.push(self.getp()))
+        imp(0x68, 4, lambda: set_("a", self.nz(self.pull()))); imp(0x28, 4, lambda: self.setp(self.pull()))
+
+        def jmp():
+            self.pc = self.rd16(self.pc); return 3
+        def jmpi():
+            self.pc, _ = self.m_ind(); return 5
+        def jsr():
+            a = self.rd16(self.pc); r = self.pc + 1
+            self.push(r >> 8); self.push(r & 0xff); self.pc = a; return 6
+        def rts():
+            lo = self.pull(); hi = self.pull(); self.pc = ((hi << 8) | lo) + 1; return 6
+        def rti():
+            self.setp(self.pull()); lo = self.pull(); hi = self.pull(); self.pc = (hi << 8) | lo; return 6
+        def brk():
+            r = self.pc + 1
+            self.push(r >> 8); self.push(r & 0xff); self.push(self.getp(1)); self.i = 1
+            self.pc = self.rd16(0xfffe); return 7
+        t[0x4c] = jmp; t[0x6c] = jmpi; t[0x20] = jsr; t[0x60] = rts; t[0x40] = rti; t[0x00] = brk
+
+    def step(self):
+        opcode = self.rd(self.pc)
+        fn = self.table.get(opcode)
+        if fn is None:
+            raise RuntimeError(f"illegal opcode ${opcode:02x} at ${self.pc:04x}")
+        self.pc += 1
+        c = fn()
+        self.pc &= 0xffff
+        self.cycles += c
+        return c
+
+class C64(CPU):
+    '''64K RAM, I/O at $d000-$dfff depending on $01, VIC raster counter
+    and optional badline stalls. No ROMs: calls into mapped in BASIC or
+    Kernal ROM return immediately.'''
+
+    def __init__(self, badlines=False):
+        super().__init__()
+        self.io = bytearray(0x1000)
+        self.badlines = badlines
+        self.stall = 0
+        self.raster_line = 0
+        self.trace = []
+        self.mem[0x00] = 0x2f
+        self.mem[0x01] = 0x37
+        self.io[0x011] = 0x1b
+        self.io[0xc00] = 0xff
+
+    def io_visible(self):
+        port = self.mem[0x01]
+        return (port & 0x03) != 0 and (port & 0x04) != 0
+
+    def time(self):
+        return self.cycles + self.stall
+
+    def rd(self, a):
+        a &= 0xffff
+        if 0xd000 <= a < 0xe000 and self.io_visible():
+            return self.rd_io(a)
+        return self.mem[a]
+
+    def wr(self, a, v):
+        a &= 0xffff
+        if 0xd000 <= a < 0xe000 and self.io_visible():
+            self.wr_io(a, v & 0xff)
+            return
+        self.mem[a] = v & 0xff
+
+    def rd_io(self, a):
+        if a < 0xd400:
+            reg = a & 0x3f
+            if reg == 0x11: return (self.io[0x11] & 0x7f) | ((self.raster_line >> 1) & 0x80)
+            if reg == 0x12: return self.raster_line & 0xff
+            return self.io[reg]
+        if a == 0xdc01: return 0xff                     # no keys pressed
+        if a in (0xdc0d, 0xdd0d): return 0x00           # no cia irqs pending
+        if a >= 0xde00: return 0xff                     # open bus, no expansion
+        return self.io[a - 0xd000]
+
+    def wr_io(self, a, v):
+        if TRACE_PORTS[0] <= a <= TRACE_PORTS[1]:
+            self.trace.append((self.raster_line, self.time() % CYCLES_PER_LINE, a, v))
+        if a < 0xd400: a = 0xd000 + (a & 0x3f)
+        self.io[a - 0xd000] = v
+
+    def rom_visible(self, a):
+        port = self.mem[0x01]
+        if a >= 0xe000: return (port & 0x02) != 0
+        if 0xa000 <= a < 0xc000: return (port & 0x03) == 0x03
+        return False
+
+    def is_badline(self, line):
+        ctrl = self.io[0x11]
+        return (FIRST_BADLINE <= line <= LAST_BADLINE and (ctrl & 0x10) != 0 and (line & 0x07) == (ctrl & 0x07))
+
+    def step(self):
+        if self.pc >= 0xa000 and self.rom_visible(self.pc):
+            lo = self.pull(); hi = self.pull()       # rom stub: rts
+            self.pc = (((hi << 8) | lo) + 1) & 0xffff
+            self.cycles += 6
+            c = 6
+        else:
+            c = super().step()
+        line = (self.time() // CYCLES_PER_LINE) % RASTER_LINES
+        while line != self.raster_line:
+            self.raster_line = (self.raster_line + 1) % RASTER_LINES
+            if self.badlines and self.is_badline(self.raster_line):
+                self.stall += BADLINE_STALL
+                line = (self.time() // CYCLES_PER_LINE) % RASTER_LINES
+        return c
+
+def usage():
+    print("Usage: bench64 [-u] [-t PERCENT] [-p PRG] [-s SYMBOLS] [-m] [-v] [-T FILE] CONFIG")
+    print("")
+    print("CONFIG            : Benchmark definition or variant suite (.json)")
+    print("-u, --update      : Write measured cycles as new baseline")
+    print("-t, --tolerance   : Allowed regression in percent (default 0)")
+    print("-p, --program     : Program file, overrides the config")
+    print("-s, --symbols     : ELF or label file, overrides the config")
+    print("-m, --markdown    : Print the variant comparison as markdown table")
+    print("-v, --verbose     : Print setup and boot details")
+    print("-T, --trace       : Write trace port writes to file (see trace64 -r)")
+
+def load_prg(cpu, filename):
+    '''Load .prg into memory, returns (load address, data)'''
+    with open(filename, "rb") as in_file:
+        data = in_file.read()
+    if len(data) < 3:
+        raise RuntimeError(f"{filename} is not a valid program")
+    address = data[0] | (data[1] << 8)
+    cpu.mem[address:address+len(data)-2] = data[2:]
+    return address, data
+
+def read_elf_sections(data):
+    '''Read (name, type, flags, address, offset, size) of the ELF32 sections'''
+    shoff = struct.unpack_from("<I", data, 0x20)[0]
+    shentsize, shnum, shstrndx = struct.unpack_from("<HHH", data, 0x2e)
+    headers = []
+    for i in range(shnum):
+        headers.append(struct.unpack_from("<IIIIIIIIII", data, shoff + i * shentsize))
+    names_offset = headers[shstrndx][4] if shstrndx < shnum else 0
+    sections = []
+    for header in headers:
+        name = ""
+        if names_offset:
+            start = names_offset + header[0]
+            name = data[start:data.index(b"\0", start)].decode("ascii", "replace")
+        sections.append((name, header[1], header[2], header[3], header[4], header[5]))
+    return sections
+
+def read_elf_symbols(data):
+    '''Read (name, value, size, type, section index) entries from the ELF32 symbol table'''
+    entries = []
+    shoff = struct.unpack_from("<I", data, 0x20)[0]
+    shentsize, shnum = struct.unpack_from("<HH", data, 0x2e)
+    sections = []
+    for i in range(shnum):
+        sections.append(struct.unpack_from("<IIIIIIIIII", data, shoff + i * shentsize))
+    for section in sections:
+        if section[1] != 2: continue    # SHT_SYMTAB
+        strtab = sections[section[6]]
+        str_offset = strtab[4]
+        for pos in range(section[4], section[4] + section[5], 16):
+            name_ofs, value, size, info, other, shndx = struct.unpack_from("<IIIBBH", data, pos)
+            if name_ofs == 0: continue
+            end = data.index(b"\0", str_offset + name_ofs)
+            name = data[str_offset + name_ofs:end].decode("ascii", "replace")
+            entries.append((name, value & 0xffff, size, info & 0x0f, shndx))
+    return entries
+
+def load_elf_symbols(data):
+    '''Read symbols from the ELF32 symbol table'''
+    symbols = {}
+    for name, value, size, type, shndx in read_elf_symbols(data):
+        symbols[name] = value
+    return symbols
+
+def load_label_symbols(text):
+    '''Read VICE label files (al C:080d .name) or assignments (name = $080d)'''
+    symbols = {}
+    for line in text.splitlines():
+        parts = line.replace("=", " = ").split()
+        if len(parts) >= 3 and parts[0] == "al":
+            symbols[parts[2].lstrip(".")] = int(parts[1].split(":")[-1], 16)
+        elif len(parts) >= 3 and parts[1] == "=":
+            value = parts[2].split(";")[0]
+            try:
+                if value.startswith("$"): symbols[parts[0]] = int(value[1:], 16)
+                elif value.startswith("0x"): symbols[parts[0]] = int(value, 16)
+                else: symbols[parts[0]] = int(value)
+            except ValueError:
+                pass
+    return symbols
+
+def load_symbols(filename):
+    with open(filename, "rb") as in_file:
+        data = in_file.read()
+    if data[:4] == b"\x7fELF":
+        return load_elf_symbols(data)
+    return load_label_symbols(data.decode("ascii", "replace"))
+
+class Harness:
+
+    def __init__(self, cpu, symbols, verbose=False):
+        self.cpu = cpu
+        self.symbols = symbols
+        self.verbose = verbose
+        self.rc_base = symbols.get("__rc0", DEFAULT_RC_BASE)
+        self.program_size = 0
+
+    def resolve(self, value):
+        if isinstance(value, int): return value
+        if value in self.symbols: return self.symbols[value]
+        if value.startswith("$"): return int(value[1:], 16)
+        raise RuntimeError(f"unknown symbol '{value}'")
+
+    def set_args(self, args):
+        '''llvm-mos calling convention: pointers in rs1, rs2, ..., other
+        values split into bytes and passed in A, X, then rc2, rc3, ...'''
+        cpu = self.cpu
+        byte_regs = ["a", "x"]
+        next_rc = 2
+        used = set()
+        for arg in args:
+            if arg[0] == "ptr":
+                rc = 2
+                while rc in used: rc += 2
+                used.update((rc, rc + 1))
+                value = self.resolve(arg[1])
+                cpu.mem[self.rc_base + rc] = value & 0xff
+                cpu.mem[self.rc_base + rc + 1] = (value >> 8) & 0xff
+        for arg in args:
+            if arg[0] == "ptr": continue
+            value = self.resolve(arg[1])
+            size = 2 if arg[0] in ("u16", "i16") else 1
+            for i in range(size):
+                byte = (value >> (8 * i)) & 0xff
+                if byte_regs:
+                    setattr(cpu, byte_regs.pop(0), byte)
+                else:
+                    while next_rc in used: next_rc += 1
+                    cpu.mem[self.rc_base + next_rc] = byte
+                    used.add(next_rc)
+
+    def run_until(self, stop, max_cycles=MAX_CYCLES):
+        cpu = self.cpu
+        start = cpu.time()
+        while cpu.pc != stop:
+            cpu.step()
+            if cpu.time() - start > max_cycles:
+                raise RuntimeError(f"no return after {max_cycles} cycles (pc=${cpu.pc:04x})")
+
+    def boot(self, entry, until, max_cycles=MAX_CYCLES):
+        '''Run the program from its entry point until a symbol is reached'''
+        cpu = self.cpu
+        cpu.pc = entry
+        self.run_until(self.resolve(until), max_cycles)
+        if self.verbose:
+            print(f"boot: reached {until} after {cpu.time()} cycles")
+
+    def call(self, target, args=(), irq=False):
+        '''Call a function (jsr) or an interrupt handler, returns
+        (cpu cycles, badline stall cycles) including the call overhead'''
+        cpu = self.cpu
+        address = self.resolve(target)
+        self.set_args(args)
+
+        start_cycles = cpu.cycles
+        start_stall = cpu.stall
+        if irq:
+            cpu.push(RETURN_ADDRESS >> 8)
+            cpu.push(RETURN_ADDRESS & 0xff)
+            cpu.push(cpu.getp(0))
+            cpu.i = 1
+            cpu.cycles += 7
+        else:
+            ret = (RETURN_ADDRESS - 1) & 0xffff
+            cpu.push(ret >> 8)
+            cpu.push(ret & 0xff)
+            cpu.cycles += 6
+        cpu.pc = address
+        self.run_until(RETURN_ADDRESS)
+        return cpu.cycles - start_cycles, cpu.stall - start_stall
+
+def relative_path(base, filename):
+    path = Path(filename)
+    if not path.is_absolute(): path = Path(base) / path
+    return path
+
+def prepare(config, base, program=None, symbols_file=None, badlines=False, verbose=False):
+    '''Load program and symbols, boot and run the setup calls'''
+    program = Path(program) if program else relative_path(base, config["program"])
+    if symbols_file:
+        symbols_file = Path(symbols_file)
+    elif "symbols" in config:
+        symbols_file = relative_path(base, config["symbols"])
+    else:
+        symbols_file = Path(str(program) + ".elf")
+
+    cpu = C64(badlines=badlines)
+    load_address, data = load_prg(cpu, program)
+    symbols = load_symbols(symbols_file)
+    harness = Harness(cpu, symbols, verbose)
+    harness.program_size = len(data) - 2
+
+    # soft stack for calls without boot
+    stack = symbols.get("__stack", DEFAULT_STACK)
+    cpu.mem[harness.rc_base] = stack & 0xff
+    cpu.mem[harness.rc_base + 1] = stack >> 8
+
+    if "boot" in config:
+        entry = get_sys_address(data[2:]) if load_address == 0x0801 else load_address
+        if entry is None:
+            raise RuntimeError(f"{program}: no SYS address found")
+        harness.boot(entry, config["boot"])
+
+    for step in config.get("setup", []):
+        cycles, stall = harness.call(step["call"], step.get("args", []), step.get("irq", False))
+        if verbose: print(f"setup: {step['call']} {cycles} cycles")
+
+    return program, harness
+
+def run_suite(config, base, markdown=False, verbose=False):
+    '''Run the same workloads in each variant, print cycles per frame and sizes'''
+    frames = config.get("frames", 50)
+    badlines = config.get("badlines", False)
+    workloads = config["workloads"]
+    variants = config["variants"]
+
+    results = {}
+    sizes = {}
+    for variant in variants:
+        name = variant["name"]
+        program, harness = prepare(variant, base, badlines=badlines, verbose=verbose)
+        sizes[name] = harness.program_size
+        for workload in workloads:
+            steps = variant["workloads"].get(workload)
+            if not steps: continue
+            total = 0
+            for _ in range(frames):
+                for step in steps:
+                    for _ in range(step.get("repeat", 1)):
+                        cycles, stall = harness.call(step["call"], step.get("args", []), step.get("irq", False))
+                        total += cycles + stall
+            results[(name, workload)] = total // frames
+
+    rows = []
+    for workload in workloads:
+        rows.append([workload] + [str(results.get((v["name"], workload), "-")) for v in variants])
+    # only workloads all variants implement are comparable
+    common = [w for w in workloads if all((v["name"], w) in results for v in variants)]
+    excluded = [w for w in workloads if w not in common]
+    frame_totals = [str(sum(results[(v["name"], w)] for w in common)) if common else "-" for v in variants]
+    rows.append(["total per frame" if not excluded else "total (common)"] + frame_totals)
+    rows.append(["program size (bytes)"] + [str(sizes[v["name"]]) for v in variants])
+
+    header = ["cycles per frame"] + [v["name"] for v in variants]
+    if markdown:
+        print("| " + " | ".join(header) + " |")
+        print("|" + "---|" + "---:|" * len(variants))
+        for row in rows:
+            print("| " + " | ".join(row) + " |")
+        if excluded: print(f"\nTotal without {', '.join(excluded)} (not implemented by all variants).")
+        return
+
+    print(f"frames: {frames}, badlines: {'on' if badlines else 'off'}")
+    print("")
+    print(f"{header[0]:<24}" + "".join(f"{h:>18}" for h in header[1:]))
+    for row in rows:
+        print(f"{row[0]:<24}" + "".join(f"{c:>18}" for c in row[1:]))
+    if excluded:
+        print("")
+        print(f"total without: {', '.join(excluded)} (not implemented by all variants)")
+
+def write_trace(cpu, trace_file):
+    with open(trace_file, "w") as out_file:
+        for line, cycle, address, value in cpu.trace:
+            out_file.write(f"{line} {cycle} {address:04x} {value:02x}\n")
+
+def run(config_file, program=None, symbols_file=None, update=False, tolerance=0.0, markdown=False, verbose=False, trace_file=None):
+    with open(config_file, "r") as in_file:
+        config = json.load(in_file)
+    base = Path(config_file).parent
+
+    if "variants" in config:
+        run_suite(config, base, markdown, verbose)
+        return
+
+    program, harness = prepare(config, base, program, symbols_file, config.get("badlines", False), verbose)
+    cpu = harness.cpu
+    symbols = harness.symbols
+
+    baseline_file = relative_path(base, config.get("baseline", "baseline.json"))
+    baseline = {}
+    if baseline_file.exists():
+        with open(baseline_file, "r") as in_file:
+            baseline = json.load(in_file)
+
+    print(f"program: {program}")
+    print(f"badlines: {'on' if cpu.badlines else 'off'}")
+    print("")
+    print(f"{'benchmark':<32} {'calls':>5} {'cycles':>10} {'stall':>8} {'total':>10} {'baseline':>10} {'delta':>8}")
+
+    results = {}
+    failed = 0
+    for bench in config["benchmarks"]:
+        name = bench["name"]
+        calls = bench.get("calls", 1)
+        cycles = stall = 0
+        for _ in range(calls):
+            c, s = harness.call(bench["call"], bench.get("args", []), bench.get("irq", False))
+            cycles += c
+            stall += s
+        total = cycles + stall
+        results[name] = total
+
+        reference = baseline.get(name)
+        if reference is None:
+            delta = "new"
+        else:
+            change = 100.0 * (total - reference) / max(reference, 1)
+            delta = f"{change:+.1f}%"
+            if change > tolerance:
+                delta += " !"
+                failed += 1
+        print(f"{name:<32} {calls:>5} {cycles:>10} {stall:>8} {total:>10} {str(reference or '-'):>10} {delta:>8}")
+
+    if trace_file:
+        write_trace(cpu, trace_file)
+
+    if update:
+        with open(baseline_file, "w") as out_file:
+            json.dump(results, out_file, indent=4)
+            out_file.write("\n")
+        print("")
+        print(f"baseline written to {baseline_file}")
+    elif failed:
+        print("")
+        print(f"{failed} benchmark(s) regressed")
+        sys.exit(1)
+
+def main():
+    '''Main entry'''
+    try:
+        opts, args = getopt.getopt(sys.argv[1:], "hut:p:s:mvT:", ["help", "update", "tolerance=", "program=", "symbols=", "markdown", "verbose", "trace="])
+    except getopt.GetoptError:
+        usage()
+        sys.exit(2)
+
+    if len(args) < 1:
+        usage()
+        sys.exit()
+
+    update = False
+    tolerance = 0.0
+    program = None
+    symbols = None
+    markdown = False
+    verbose = False
+    trace_file = None
+
+    for o, a in opts:
+        if o in ("-h", "--help"):
+            usage()
+            sys.exit()
+        elif o in ("-u", "--update"):
+            update = True
+        elif o in ("-t", "--tolerance"):
+            tolerance = float(a)
+        elif o in ("-p", "--program"):
+            program = a
+        elif o in ("-s", "--symbols"):
+            symbols = a
+        elif o in ("-m", "--markdown"):
+            markdown = True
+        elif o in ("-v", "--verbose"):
+            verbose = True
+        elif o in ("-T", "--trace"):
+            trace_file = a
+
+    config = Path(args[0])
+    if not config.exists() or not os.path.isfile(config):
+        print(f"{config} does not exist or is invalid")
+        sys.exit(3)
+
+    try:
+        run(config, program, symbols, update, tolerance, markdown, verbose, trace_file)
+    except RuntimeError as err:
+        print(f"error: {err}")
+        sys.exit(1)
+
+if __name__ == "__main__":
+    main()
@@ -10,6 +10,16 @@ import png
 HEXCHARS = "0123456789abcdef"
 TYPENAME_BITMAP = "bitmap_info_t"
 
+# pepto palette
+PALETTE = [
+    (0x00, 0x00, 0x00), (0xff, 0xff, 0xff), (0x68, 0x37, 0x2b), (0x70, 0xa4, 0xb2),
+    (0x6f, 0x3d, 0x86), (0x58, 0x8d, 0x43), (0x35, 0x28, 0x79), (0xb8, 0xc7, 0x6f),
+    (0x6f, 0x4f, 0x25), (0x43, 0x39, 0x00), (0x9a, 0x67, 0x59), (0x44, 0x44, 0x44),
+    (0x6c, 0x6c, 0x6c), (0x9a, 0xd2, 0x84), (0x6c, 0x5e, 0xb5), (0x95, 0x95, 0x95)
+]
+
+MAX_CHARS = 256
+
 class Rect:
     def __init__(self, left, top, right, bottom):
         self.set(left, top, right, bottom)
@@ -151,6 +161,217 @@ def process(input_file, rect=None, index=None, flag_multicolor=False):
 
     return s # , rect.width, rect.height, bit_rows
 
+def read_pixels(input_file):
+    '''image as rows of palette indices, transparent pixels are None'''
+    r = png.Reader(input_file)
+    width, height, rows, info = r.read()
+    bytes_per_pixel = info["planes"]
+    has_alpha = info["alpha"]
+    palette = info.get("palette")
+    max_value = (1 << info["bitdepth"]) - 1
+
+    pixels = []
+    for row in rows:
+        pixel_row = []
+        for x in range(width):
+            ofs = x * bytes_per_pixel
+            alpha = 255
+            if palette:
+                col = palette[row[ofs]]
+                rgb = col[0:3]
+                if len(col) > 3: alpha = col[3]
+            elif bytes_per_pixel >= 3:
+                rgb = tuple(row[ofs:ofs+3])
+                if has_alpha: alpha = row[ofs+3]
+            else:
+                v = row[ofs] * 255 // max_value
+                rgb = (v, v, v)
+                if has_alpha: alpha = row[ofs+1]
+            pixel_row.append(nearest_color(rgb) if alpha >= 128 else None)
+        pixels.append(pixel_row)
+
+    return width, height, pixels
+
+def nearest_color(rgb, candidates=range(16)):
+    best = None
+    best_distance = None
+    for index in candidates:
+        col = PALETTE[index]
+        distance = (rgb[0]-col[0])**2 + (rgb[1]-col[1])**2 + (rgb[2]-col[2])**2
+        if best_distance == None or distance < best_distance:
+            best = index
+            best_distance = distance
+    return best
+
+def count_colors(pixels):
+    counts = {}
+    for col in pixels:
+        if col != None: counts[col] = counts.get(col, 0) + 1
+    return sorted(counts, key=lambda col: -counts[col])
+
+def get_cells(pixels, width, height, cell_width):
+    '''8 rows of pixels per cell, left to right, top to bottom'''
+    cells = []
+    for y in range(0, height, 8):
+        for x in range(0, width, cell_width):
+            cells.append([pixels[y+row][x:x+cell_width] for row in range(8)])
+    return cells
+
+def encode_cell(cell, colors, multicolor):
+    '''8 bytes from a cell, colors are the palette indices of bit pattern 0..n'''
+    bits_per_pixel = 2 if multicolor else 1
+    data = []
+    lossy = False
+    for row in cell:
+        value = 0
+        for col in row:
+            if col == None: col = colors[0]
+            if col in colors:
+                index = colors.index(col)
+            else:
+                index = colors.index(nearest_color(PALETTE[col], colors))
+                lossy = True
+            value = (value << bits_per_pixel) | index
+        data.append(value)
+    return tuple(data), lossy
+
+def char_distance(a, b, multicolor):
+    '''number of differing pixels'''
+    distance = 0
+    for i in range(8):
+        diff = a[i] ^ b[i]
+        if multicolor: diff = (diff | (diff >> 1)) & 0x55
+        distance += bin(diff).count("1")
+    return distance
+
+def convert_charset(input_file, multicolor=False, background=None, max_error=0):
+    width, height, pixels = read_pixels(input_file)
+    cell_width = 4 if multicolor else 8
+    if width % cell_width != 0 or height % 8 != 0:
+        raise ValueError(f"image size {width}x{height} is not a multiple of the {cell_width}x8 cell size")
+
+    # common colors: $d021 (and $d022, $d023 in multi-color mode)
+    common = count_colors([col for row in pixels for col in row])
+    if background != None:
+        if background in common: common.remove(background)
+        common.insert(0, background)
+    common = (common + [0, 0, 0])[0:3 if multicolor else 1]
+
+    cells = get_cells(pixels, width, height, cell_width)
+    chars = []
+    colors = []
+    lossy_cells = 0
+    for cell in cells:
+        # the cell color goes to color RAM, 0-7 in multi-color mode
+        remaining = [col for col in count_colors([col for row in cell for col in row]) if col not in common]
+        cell_color = remaining[0] if remaining else 0
+        if multicolor and cell_color > 7:
+            cell_color = nearest_color(PALETTE[cell_color], range(8))
+        char, lossy = encode_cell(cell, common + [cell_color], multicolor)
+        if lossy: lossy_cells += 1
+        chars.append(char)
+        colors.append(cell_color | 0x08 if multicolor else cell_color)
+
+    # identical chars first, then merge near-identical ones, most used first
+    usage = {}
+    for char in chars:
+        usage[char] = usage.get(char, 0) + 1
+    unique = sorted(usage, key=lambda char: -usage[char])
+
+    charset = []
+    mapping = {}
+    merged_cells = 0
+    for char in unique:
+        target = None
+        if max_error > 0:
+            best_distance = max_error + 1
+            for index, existing in enumerate(charset):
+                distance = char_distance(char, existing, multicolor)
+                if distance < best_distance:
+                    target = index
+                    best_distance = distance
+        if target == None:
+            target = len(charset)
+            charset.append(char)
+        else:
+            merged_cells += usage[char]
+        mapping[char] = target
+
+    info = {
+        "name": os.path.splitext(os.path.basename(input_file))[0],
+        "width": width,
+        "height": height,
+        "columns": width // cell_width,
+        "rows": height // 8,
+        "multicolor": multicolor,
+        "common": common,
+        "unique": len(unique),
+        "merged_cells": merged_cells,
+        "lossy_cells": lossy_cells,
+        "max_error": max_error
+    }
+
+    screen = [mapping[char] for char in chars]
+
+    return charset, screen, colors, info
+
+def format_bytes(data, per_line=16):
+    lines = []
+    for i in range(0, len(data), per_line):
+        lines.append("  " + ",".join(f"0x{value:02x}" for value in data[i:i+per_line]))
+    return ",\n".join(lines)
+
+def charset_to_string(name, charset, screen, colors, info):
+    mode = "multi-color" if info["multicolor"] else "hi-res"
+    lines = []
+    lines.append("////////////////////////////////////////////////////////////////////////////////")
+    lines.append(f"// Charset image '{info['name']}' ({mode}, {info['columns']}x{info['rows']}, {len(charset)} chars)")
+    lines.append("// @generated by bitmap2cpp")
+    lines.append("// clang-format off")
+    lines.append("////////////////////////////////////////////////////////////////////////////////")
+    lines.append("")
+    lines.append("#include <cstddef>")
+    lines.append("#include <cstdint>")
+    lines.append("")
+    lines.append(f"extern const uint8_t {name}_charset[] = {{")
+    for index, char in enumerate(charset):
+        separator = "," if index < len(charset) - 1 else " "
+        lines.append("  " + ",".join(f"0x{value:02x}" for value in char) + f"{separator} // {index}")
+    lines.append("};")
+    lines.append("")
+    lines.append(f"extern const size_t {name}_charset_size = {len(charset) * 8};")
+    lines.append("")
+    lines.append(f"extern const uint8_t {name}_screen[] = {{")
+    lines.append(format_bytes(screen, info["columns"] if info["columns"] <= 40 else 16))
+    lines.append("};")
+    lines.append("")
+    lines.append(f"extern const uint8_t {name}_colors[] = {{")
+    lines.append(format_bytes(colors, info["columns"] if info["columns"] <= 40 else 16))
+    lines.append("};")
+    lines.append("")
+    if info["multicolor"]:
+        lines.append("// $d021, $d022, $d023")
+    else:
+        lines.append("// $d021")
+    lines.append(f"extern const uint8_t {name}_common_colors[] = {{ {', '.join(f'0x{col:02x}' for col in info['common'])} }};")
+    lines.append("")
+    return "\n".join(lines)
+
+def print_charset_report(charset, screen, info):
+    cells = len(screen)
+    mode = "multi-color" if info["multicolor"] else "hi-res"
+    print(f"{info['name']}: {info['width']}x{info['height']} {mode}, {cells} cells, {info['unique']} unique chars")
+    if info["max_error"] > 0:
+        print(f"merged: {info['unique'] - len(charset)} chars ({info['merged_cells']} cells, up to {info['max_error']} pixels off)")
+    if info["lossy_cells"] > 0:
+        print(f"lossy: {info['lossy_cells']} cells have more colors than the mode allows")
+
+    charset_size = len(charset) * 8
+    total = charset_size + cells * 2
+    bitmap_total = cells * 8 + cells * 2
+    print(f"charset {charset_size} + screen {cells} + colors {cells} = {total} bytes "
+          f"(bitmap {cells * 8} + {cells} + {cells} = {bitmap_total}, saved {bitmap_total - total}, {bitmap_total / total:.1f}x)")
+
 def get_bit_char(v):
     if v: return '1'
     return '0'
@@ -223,21 +444,30 @@ def save(filename, content):
 
 def usage():
     print("Usage: bitmap2cpp [-m|--multicolor] -o output input...")
+    print("       bitmap2cpp -c [-m] [-e PIXELS] [-g COLOR] [-n NAME] -o output input")
     print("")
     print("-m, --multicolor  : Enable multi-color mode")
     print("-o                : Filename of C++ source file to be generated")
+    print("-c, --charset     : Convert to charset, screen and colors instead of sprites")
+    print("-e, --error       : Merge chars differing in up to PIXELS pixels (charset mode)")
+    print("-g, --background  : Background color index (charset mode, default: most used)")
+    print("-n, --name        : Prefix of the generated arrays (charset mode, default: input name)")
     print("INPUT             : PNG input files")
 
 def main():
 
     try:
-        opts, args = getopt.getopt(sys.argv[1:], "hmo:", ["multi", "help", "output="])
+        opts, args = getopt.getopt(sys.argv[1:], "hmo:ce:g:n:", ["multi", "help", "output=", "charset", "error=", "background=", "name="])
     except getopt.GetoptError:
         usage()
         sys.exit(2)
 
     output = None
     multi = False
+    charset_mode = False
+    max_error = 0
+    background = None
+    name = None
     for o, a in opts:
         if o in ("-m", "--multi"):
             multi = True
@@ -246,6 +476,35 @@ def main():
             sys.exit()
         if o in ("-o", "--output"):
             output = a
+        if o in ("-c", "--charset"):
+            charset_mode = True
+        if o in ("-e", "--error"):
+            max_error = int(a)
+        if o in ("-g", "--background"):
+            background = int(a, 0)
+        if o in ("-n", "--name"):
+            name = a
+
+    if charset_mode:
+        if len(args) != 1:
+            usage()
+            sys.exit(2)
+        try:
+            charset, screen, colors, info = convert_charset(args[0], multi, background, max_error)
+        except ValueError as e:
+            print(f"{args[0]}: {e}")
+            sys.exit(1)
+        if len(charset) > MAX_CHARS:
+            print(f"{args[0]}: {len(charset)} chars needed, maximum is {MAX_CHARS} (try a higher -e)")
+            sys.exit(1)
+        s = charset_to_string(name or info["name"], charset, screen, colors, info)
+        if output:
+            with open(output, "w") as text_file:
+                text_file.write(s)
+            print_charset_report(charset, screen, info)
+        else:
+            print(s)
+        return
 
     s = ""
     file_index = 0
@@ -65,50 +65,50 @@ JumpInstructions = [
 
 OpcodeTable = [
     # num,name,addressing,cycles,cross_page
-    (0x69,0,AddressMode.imm,2,1), # ADC
-    (0x65,0,AddressMode.zp,3,1),
-    (0x75,0,AddressMode.zpx,4,1),
-    (0x6D,0,AddressMode.abs,4,1),
+    (0x69,0,AddressMode.imm,2,0), # ADC
+    (0x65,0,AddressMode.zp,3,0),
+    (0x75,0,AddressMode.zpx,4,0),
+    (0x6D,0,AddressMode.abs,4,0),
     (0x7D,0,AddressMode.abx,4,1),
     (0x79,0,AddressMode.aby,4,1),
-    (0x61,0,AddressMode.izx,6,1),
+    (0x61,0,AddressMode.izx,6,0),
     (0x71,0,AddressMode.izy,5,1),
 
-    (0x29,1,AddressMode.imm,2,1), # AND
-    (0x25,1,AddressMode.zp,3,1),
-    (0x35,1,AddressMode.zpx,4,1),
-    (0x2D,1,AddressMode.abs,4,1),
+    (0x29,1,AddressMode.imm,2,0), # AND
+    (0x25,1,AddressMode.zp,3,0),
+    (0x35,1,AddressMode.zpx,4,0),
+    (0x2D,1,AddressMode.abs,4,0),
     (0x3D,1,AddressMode.abx,4,1),
     (0x39,1,AddressMode.aby,4,1),
-    (0x21,1,AddressMode.izx,6,1),
+    (0x21,1,AddressMode.izx,6,0),
     (0x31,1,AddressMode.izy,5,1),
 
     (0x0A,2,AddressMode.acc,2,0), # ASL
     (0x06,2,AddressMode.zp,5,0),
     (0x16,2,AddressMode.zpx,6,0),
     (0x0E,2,AddressMode.abs,6,0),
-    (0x1E,2,AddressMode.abx,6,0),
+    (0x1E,2,AddressMode.abx,7,0),
 
-    (0x90,3,AddressMode.rel,4,1), # BCC
+    (0x90,3,AddressMode.rel,2,1), # BCC
 
-    (0xB0,4,AddressMode.rel,4,1), # BCS
+    (0xB0,4,AddressMode.rel,2,1), # BCS
 
-    (0xF0,5,AddressMode.rel,4,1), # BEQ
+    (0xF0,5,AddressMode.rel,2,1), # BEQ
 
     (0x24,6,AddressMode.zp,3,0), # BIT
     (0x2C,6,AddressMode.abs,4,0),
 
-    (0x30,7,AddressMode.rel,4,1), # BMI
+    (0x30,7,AddressMode.rel,2,1), # BMI
 
-    (0xD0,8,AddressMode.rel,4,1), # BNE
+    (0xD0,8,AddressMode.rel,2,1), # BNE
 
-    (0x10,9,AddressMode.rel,4,1), # BPL
+    (0x10,9,AddressMode.rel,2,1), # BPL
 
     (0x00,10,AddressMode.imp,7,0), # BRK
 
-    (0x50,11,AddressMode.rel,4,1), # BVC
+    (0x50,11,AddressMode.rel,2,1), # BVC
 
-    (0x70,12,AddressMode.rel,4,1), # BVS
+    (0x70,12,AddressMode.rel,2,1), # BVS
 
     (0x18,13,AddressMode.imp,2,0), # CLC
 
@@ -122,10 +122,10 @@ OpcodeTable = [
     (0xC5,17,AddressMode.zp,3,0),
     (0xD5,17,AddressMode.zpx,4,0),
     (0xCD,17,AddressMode.abs,4,0),
-    (0xDD,17,AddressMode.abx,4,0),
-    (0xD9,17,AddressMode.aby,4,0),
+    (0xDD,17,AddressMode.abx,4,1),
+    (0xD9,17,AddressMode.aby,4,1),
     (0xC1,17,AddressMode.izx,6,0),
-    (0xD1,17,AddressMode.izy,5,0),
+    (0xD1,17,AddressMode.izy,5,1),
 
     (0xE0,18,AddressMode.imm,2,0), # CPX
     (0xE4,18,AddressMode.zp,3,0),
@@ -138,25 +138,25 @@ OpcodeTable = [
     (0xC6,20,AddressMode.zp,5,0), # DEC
     (0xD6,20,AddressMode.zpx,6,0),
     (0xCE,20,AddressMode.abs,6,0),
-    (0xDE,20,AddressMode.abx,6,0),
+    (0xDE,20,AddressMode.abx,7,0),
 
     (0xCA,21,AddressMode.imp,2,0), # DEX
 
     (0x88,22,AddressMode.imp,2,0), # DEY
 
-    (0x49,23,AddressMode.imm,2,1), # EOR
-    (0x45,23,AddressMode.zp,3,1),
-    (0x55,23,AddressMode.zpx,4,1),
-    (0x4D,23,AddressMode.abs,4,1),
+    (0x49,23,AddressMode.imm,2,0), # EOR
+    (0x45,23,AddressMode.zp,3,0),
+    (0x55,23,AddressMode.zpx,4,0),
+    (0x4D,23,AddressMode.abs,4,0),
     (0x5D,23,AddressMode.abx,4,1),
     (0x59,23,AddressMode.aby,4,1),
-    (0x41,23,AddressMode.izx,6,1),
+    (0x41,23,AddressMode.izx,6,0),
     (0x51,23,AddressMode.izy,5,1),
 
     (0xE6,24,AddressMode.zp,5,0), # INC
     (0xF6,24,AddressMode.zpx,6,0),
     (0xEE,24,AddressMode.abs,6,0),
-    (0xFE,24,AddressMode.abx,6,0),
+    (0xFE,24,AddressMode.abx,7,0),
 
     (0xE8,25,AddressMode.imp,2,0), # INX
 
@@ -167,32 +167,32 @@ OpcodeTable = [
 
     (0x20,28,AddressMode.abs,6,0), # JSR
 
-    (0xA9,29,AddressMode.imm,2,1), # LDA
-    (0xA5,29,AddressMode.zp,3,1),
-    (0xB5,29,AddressMode.zpx,4,1),
-    (0xAD,29,AddressMode.abs,4,1),
+    (0xA9,29,AddressMode.imm,2,0), # LDA
+    (0xA5,29,AddressMode.zp,3,0),
+    (0xB5,29,AddressMode.zpx,4,0),
+    (0xAD,29,AddressMode.abs,4,0),
     (0xBD,29,AddressMode.abx,4,1),
     (0xB9,29,AddressMode.aby,4,1),
-    (0xA1,29,AddressMode.izx,6,1),
+    (0xA1,29,AddressMode.izx,6,0),
     (0xB1,29,AddressMode.izy,5,1),
 
-    (0xA2,30,AddressMode.imm,2,1), # LDX
-    (0xA6,30,AddressMode.zp,3,1),
-    (0xB6,30,AddressMode.zpy,4,1),
-    (0xAE,30,AddressMode.abs,4,1),
+    (0xA2,30,AddressMode.imm,2,0), # LDX
+    (0xA6,30,AddressMode.zp,3,0),
+    (0xB6,30,AddressMode.zpy,4,0),
+    (0xAE,30,AddressMode.abs,4,0),
     (0xBE,30,AddressMode.aby,4,1),
 
-    (0xA0,31,AddressMode.imm,2,1), # LDY
-    (0xA4,31,AddressMode.zp,3,1),
-    (0xB4,31,AddressMode.zpx,4,1),
-    (0xAC,31,AddressMode.abs,4,1),
+    (0xA0,31,AddressMode.imm,2,0), # LDY
+    (0xA4,31,AddressMode.zp,3,0),
+    (0xB4,31,AddressMode.zpx,4,0),
+    (0xAC,31,AddressMode.abs,4,0),
     (0xBC,31,AddressMode.abx,4,1),
 
     (0x4A,32,AddressMode.acc,2,0), # LSR
     (0x46,32,AddressMode.zp,5,0),
     (0x56,32,AddressMode.zpx,6,0),
     (0x4E,32,AddressMode.abs,6,0),
-    (0x5E,32,AddressMode.abx,6,0),
+    (0x5E,32,AddressMode.abx,7,0),
 
     (0xEA,33,AddressMode.imp,2,0), # NOP
 
@@ -200,10 +200,10 @@ OpcodeTable = [
     (0x05,34,AddressMode.zp,3,0),
     (0x15,34,AddressMode.zpx,4,0),
     (0x0D,34,AddressMode.abs,4,0),
-    (0x1D,34,AddressMode.abx,4,0),
-    (0x19,34,AddressMode.aby,4,0),
+    (0x1D,34,AddressMode.abx,4,1),
+    (0x19,34,AddressMode.aby,4,1),
     (0x01,34,AddressMode.izx,6,0),
-    (0x11,34,AddressMode.izy,5,0),
+    (0x11,34,AddressMode.izy,5,1),
 
     (0x48,35,AddressMode.imp,3,0), # PHA
 
@@ -217,25 +217,25 @@ OpcodeTable = [
     (0x26,39,AddressMode.zp,5,0),
     (0x36,39,AddressMode.zpx,6,0),
     (0x2E,39,AddressMode.abs,6,0),
-    (0x3E,39,AddressMode.abx,6,0),
+    (0x3E,39,AddressMode.abx,7,0),
 
     (0x6A,40,AddressMode.acc,2,0), # ROR
     (0x66,40,AddressMode.zp,5,0),
     (0x76,40,AddressMode.zpx,6,0),
     (0x6E,40,AddressMode.abs,6,0),
-    (0x7E,40,AddressMode.abx,6,0),
+    (0x7E,40,AddressMode.abx,7,0),
 
     (0x40,41,AddressMode.imp,6,0), # RTI
 
     (0x60,42,AddressMode.imp,6,0), # RTS
 
-    (0xE9,43,AddressMode.imm,2,1), # SBC
-    (0xE5,43,AddressMode.zp,3,1),
-    (0xF5,43,AddressMode.zpx,4,1),
-    (0xED,43,AddressMode.abs,4,1),
+    (0xE9,43,AddressMode.imm,2,0), # SBC
+    (0xE5,43,AddressMode.zp,3,0),
+    (0xF5,43,AddressMode.zpx,4,0),
+    (0xED,43,AddressMode.abs,4,0),
     (0xFD,43,AddressMode.abx,4,1),
     (0xF9,43,AddressMode.aby,4,1),
-    (0xE1,43,AddressMode.izx,6,1),
+    (0xE1,43,AddressMode.izx,6,0),
     (0xF1,43,AddressMode.izy,5,1),
 
     (0x38,44,AddressMode.imp,2,0), # SEC
@@ -247,10 +247,10 @@ OpcodeTable = [
     (0x85,47,AddressMode.zp,3,0), # STA
     (0x95,47,AddressMode.zpx,4,0),
     (0x8D,47,AddressMode.abs,4,0),
-    (0x9D,47,AddressMode.abx,4,0),
-    (0x99,47,AddressMode.aby,4,0),
+    (0x9D,47,AddressMode.abx,5,0),
+    (0x99,47,AddressMode.aby,5,0),
     (0x81,47,AddressMode.izx,6,0),
-    (0x91,47,AddressMode.izy,5,0),
+    (0x91,47,AddressMode.izy,6,0),
 
     (0x86,48,AddressMode.zp,3,0), # STX
     (0x96,48,AddressMode.zpy,4,0),
@@ -322,9 +322,9 @@ OpcodeTable = [
     (0xA7,62,AddressMode.zp,3,0), # LAX
     (0xB7,62,AddressMode.zpy,4,0),
     (0xA3,62,AddressMode.izx,6,0),
-    (0xB3,62,AddressMode.izy,5,0),
+    (0xB3,62,AddressMode.izy,5,1),
     (0xAF,62,AddressMode.abs,4,0),
-    (0xBF,62,AddressMode.aby,4,0),
+    (0xBF,62,AddressMode.aby,4,1),
     (0xAB,62,AddressMode.imm,2,0),
 
     (0xC7,63,AddressMode.zp,5,0), # DCP
@@ -346,7 +346,7 @@ OpcodeTable = [
 
     (0xEB,68,AddressMode.imm,2,0), # SBC
 
-    (0xBB,69,AddressMode.aby,3,0), # LAS
+    (0xBB,69,AddressMode.aby,3,1), # LAS
 
     (0x1A,33,AddressMode.imp,2,0), # NOP
     (0x3A,33,AddressMode.imp,2,0),
@@ -407,13 +407,16 @@ OpcodeTable = [
 OpcodeMap = None
 
 def usage():
-    print("Usage: dis64 [-m] INFILE [OUTFILE]")
+    print("Usage: dis64 [-m] [-a [-s SYMBOLS] [-n COUNT]] INFILE [OUTFILE]")
     print("")
     print("INFILE            : Binary input file")
     print("OUTFILE           : Write output to file")
     print("-b, --binary      : Add hexdump of machine code")
     print("-c, --nocomments  : Add hexdump of machine code")
     print("-m, --monitor     : Run in continuous monitoring mode")
+    print("-a, --analyse     : Report cycles of functions and loops, and page crossings")
+    print("-s, --symbols     : ELF or label file for function names (default: INFILE.elf)")
+    print("-n, --top         : Number of ranked functions and loops (default: 20)")
 
 def format_byte(value):
     return "0x" + HEXCHARS[int(value/16)] + HEXCHARS[int(value%16)]
@@ -440,6 +443,9 @@ class Options:
     def __init__(self):
         self.show_binary = True
         self.show_comments = True
+        self.analyse = False
+        self.symbols_file = None
+        self.top = 20
 
 class Statement:
     def __init__(self, addr, opcode, instruction, data, data2, address_mode, cycles, cross_page, buffer):
@@ -629,106 +635,29 @@ def readInput(url):
         binary = in_file.read(buffer_size)
     return binary
 
-def process(input_file, output_file, options):
-    '''Convert C64 program file to assembler'''
-
-    fileType = FileType.Unknown
-
-    ext = Path(input_file).suffix.lower()
-    if ext == ".prg":
-        fileType = FileType.Prg
-    else:
-        print(f"unsupported file format: {ext}")
-        return
-
+def get_opcode_map():
     OpcodeMap = {}
     for opcode_info in OpcodeTable:
         opcode = opcode_info[0]
         OpcodeMap[opcode] = opcode_info
+    return OpcodeMap
 
-    binary = readInput(input_file)
-    if binary == None:
-        print("failed to read input file")
-        return
+def decode_program(binary, ofs, end_ofs, load_address):
+    '''Decode statements from binary[ofs:end_ofs]'''
 
+    OpcodeMap = get_opcode_map()
     binary_size = len(binary)
-    if binary_size < 2:
-        print("invalid file size")
-        return
-
-    ofs = 0
-
-    out_file = None
-    if output_file: out_file = open(output_file, "w")
-
-    write(out_file, "; #############################################################################")
-    write(out_file, "; #")
-    write(out_file, "; # GENERATED BY DIS64")
-    write(out_file, "; # " + str(input_file))
-    write(out_file, "; #")
-    write(out_file, "; #############################################################################")
-    write(out_file, "")
-
-    load_address = int.from_bytes(binary[ofs:ofs+2], 'little')
-    ofs += 2
-    out_s = f"*=${load_address:04X}"
-    if options.show_comments: out_s += f" ; load address ({load_address})"
-    write(out_file, out_s)
-
-    basic_line_ptr = int.from_bytes(binary[ofs:ofs+2], 'little')
-    ofs += 2
-
-    basic_line_num = int.from_bytes(binary[ofs:ofs+2], 'little')
-    ofs += 2
-
-    while ofs < binary_size:
-        dummy_byte = int.from_bytes(binary[ofs:ofs+1], 'little')
-        if dummy_byte == 0x9e: break
-        ofs += 1
-
-    sys_command = int.from_bytes(binary[ofs:ofs+1], 'little')
-    if sys_command != 0x9e:
-        print(f"unexpected basic SYS command ${sys_command:02x}")
-        return
-
-    ofs += 1
-
-    basic_statement = ""
-    while ofs < binary_size:
-        b = binary[ofs]
-        ofs += 1
-        if b == 0x0:
-            break
-        basic_statement += chr(petscii_to_ascii(b))
-
-    basic_next_line_ptr = int.from_bytes(binary[ofs:ofs+2], 'little')
-    if basic_next_line_ptr != 0x0:
-        print(f"basic next line address: ${basic_next_line_ptr:04x}")
-    ofs += 2
-
-    byte_s = ""
-    for i in range(2, ofs):
-        b = binary[i]
-        if i > 2: byte_s += ","
-        byte_s += f"${b:02x}"
-
-    out_s = f"!byte {byte_s}"
-    if options.show_comments: out_s += f" ; {basic_line_num} SYS{basic_statement}"
-    write(out_file, out_s)
-    write(out_file, "")
-
-    start_ofs = ofs
 
     statements = []
     buffer_index = 0
 
-    while ofs < binary_size:
+    while ofs < end_ofs:
         addr = load_address + ofs - 2
         opcode = binary[ofs]
 
         if opcode == 0x0:
             buffer = []
-            while ofs < binary_size and binary[ofs] == 0x0:
+            while ofs < end_ofs and binary[ofs] == 0x0:
                 buffer.append(binary[ofs])
                 ofs += 1
             statement = process_buffer(addr, buffer)
@@ -837,6 +766,11 @@ def process(input_file, output_file, options):
 
         ofs += instruction_size
 
+    return statements
+
+def link_statements(statements):
+    '''Connect jumps and irq handler setups to their targets'''
+
     for statement in statements:
         if statement.is_jump() or statement.jump_address != None:
             addr = statement.get_jump_addr()
@@ -847,6 +781,96 @@ def process(input_file, output_file, options):
                 if not statement.is_jump():
                     jump_target.irq_handler = True
 
+def process(input_file, output_file, options):
+    '''Convert C64 program file to assembler'''
+
+    fileType = FileType.Unknown
+
+    ext = Path(input_file).suffix.lower()
+    if ext == ".prg":
+        fileType = FileType.Prg
+    else:
+        print(f"unsupported file format: {ext}")
+        return
+
+    binary = readInput(input_file)
+    if binary == None:
+        print("failed to read input file")
+        return
+
+    binary_size = len(binary)
+    if binary_size < 2:
+        print("invalid file size")
+        return
+
+    if options.analyse:
+        analyse(input_file, output_file, binary, options)
+        return
+
+    ofs = 0
+
+    out_file = None
+    if output_file: out_file = open(output_file, "w")
+
+    write(out_file, "; #############################################################################")
+    write(out_file, "; #")
+    write(out_file, "; # GENERATED BY DIS64")
+    write(out_file, "; # " + str(input_file))
+    write(out_file, "; #")
+    write(out_file, "; #############################################################################")
+    write(out_file, "")
+
+    load_address = int.from_bytes(binary[ofs:ofs+2], 'little')
+    ofs += 2
+    out_s = f"*=${load_address:04X}"
+    if options.show_comments: out_s += f" ; load address ({load_address})"
+    write(out_file, out_s)
+
+    basic_line_ptr = int.from_bytes(binary[ofs:ofs+2], 'little')
+    ofs += 2
+
+    basic_line_num = int.from_bytes(binary[ofs:ofs+2], 'little')
+    ofs += 2
+
+    while ofs < binary_size:
+        dummy_byte = int.from_bytes(binary[ofs:ofs+1], 'little')
+        if dummy_byte == 0x9e: break
+        ofs += 1
+
+    sys_command = int.from_bytes(binary[ofs:ofs+1], 'little')
+    if sys_command != 0x9e:
+        print(f"unexpected basic SYS command ${sys_command:02x}")
+        return
+
+    ofs += 1
+
+    basic_statement = ""
+    while ofs < binary_size:
+        b = binary[ofs]
+        ofs += 1
+        if b == 0x0:
+            break
+        basic_statement += chr(petscii_to_ascii(b))
+
+    basic_next_line_ptr = int.from_bytes(binary[ofs:ofs+2], 'little')
+    if basic_next_line_ptr != 0x0:
+        print(f"basic next line address: ${basic_next_line_ptr:04x}")
+    ofs += 2
+
+    byte_s = ""
+    for i in range(2, ofs):
+        b = binary[i]
+        if i > 2: byte_s += ","
+        byte_s += f"${b:02x}"
+
+    out_s = f"!byte {byte_s}"
+    if options.show_comments: out_s += f" ; {basic_line_num} SYS{basic_statement}"
+    write(out_file, out_s)
+    write(out_file, "")
+
+    statements = decode_program(binary, ofs, binary_size, load_address)
+    link_statements(statements)
+
     label_index = 0
     irq_index = 0
     for statement in statements:
@@ -876,6 +900,419 @@ def process(input_file, output_file, options):
 
     return
 
+###############################################################################
+# Static cycle analysis
+###############################################################################
+
+BranchInstructions = [ 3, 4, 5, 7, 8, 9, 11, 12 ]
+
+class Function:
+    def __init__(self, name, addr, end):
+        self.name = name
+        self.addr = addr
+        self.end = end
+        self.statements = []
+        self.index = {}
+        self.loops = []
+        self.crossings = []
+        self.best = 0
+        self.worst = 0
+        self.calls_unknown = False
+        self.analysed = False
+        self.stack = None
+        self.is_irq_handler = False
+
+    def contains(self, addr):
+        return self.addr <= addr < self.end
+
+class Loop:
+    def __init__(self, function, head, tail):
+        self.function = function
+        self.head = head            # index of the first statement
+        self.tail = tail            # index of the backward jump
+        self.best = 0
+        self.worst = 0
+        self.crossings = 0
+
+def branch_crosses_page(statement):
+    return ((statement.addr + 2) ^ statement.get_jump_addr()) & 0xff00 != 0
+
+def indexed_may_cross_page(statement):
+    '''abs,X/abs,Y reads cost +1 when base+index leaves the page, which
+    can't happen for page aligned bases'''
+    if not statement.cross_page: return False
+    if statement.address_mode == AddressMode.izy: return True
+    if statement.address_mode not in (AddressMode.abx, AddressMode.aby): return False
+    return statement.data != 0x0
+
+def statement_cycles(statement):
+    '''(best, worst) cycles of a non branching statement'''
+    if statement.instruction == None: return (0, 0)
+    cycles = statement.cycles
+    return (cycles, cycles + (1 if indexed_may_cross_page(statement) else 0))
+
+def branch_taken_cycles(statement):
+    return 3 + (1 if branch_crosses_page(statement) else 0)
+
+def combine(a, b):
+    '''join two alternative paths, None means no path'''
+    if a == None: return b
+    if b == None: return a
+    return (min(a[0], b[0]), max(a[1], b[1]))
+
+def add(cycles, path):
+    if path == None: return None
+    return (cycles[0] + path[0], cycles[1] + path[1])
+
+def soft_frame_size(function, rc_base):
+    '''llvm-mos prologue: lda __rc0, sec, sbc #lo, sta __rc0 (or clc, adc
+    #-lo) and the same on __rc1 for frames of 256 bytes and more'''
+    statements = function.statements[:16]
+    size = 0
+    found = set()
+    for i, statement in enumerate(statements):
+        if statement.opcode != 0xa5 or statement.data not in (rc_base, rc_base + 1): continue
+        shift = 8 if statement.data == rc_base + 1 else 0
+        if shift in found: continue     # epilogue
+        for other in statements[i + 1:i + 3]:
+            if other.opcode == 0xe9: size += other.data << shift
+            elif other.opcode == 0x69 and shift == 0: size += (0x100 - other.data) & 0xff
+            elif other.opcode == 0x69: size += (0xff - other.data) << shift
+            else: continue
+            found.add(shift)
+            break
+    return size
+
+class Analyser:
+
+    def __init__(self, functions, rc_base=0x02):
+        self.functions = functions
+        self.by_addr = {}
+        for function in functions:
+            self.by_addr[function.addr] = function
+        self.active = set()
+        self.rc_base = rc_base
+        self.address_taken = self.find_address_taken()
+
+    def find_address_taken(self):
+        '''functions loaded as lo/hi immediates, possible targets of
+        indirect calls and irq vectors'''
+        taken = []
+        for function in self.functions:
+            immediates = [(i, s.data) for i, s in enumerate(function.statements) if s.opcode in (0xa9, 0xa2, 0xa0)]
+            for n, (i, lo) in enumerate(immediates):
+                for j, hi in immediates[n + 1:]:
+                    if j - i > 6: break
+                    target = self.by_addr.get((hi << 8) | lo)
+                    if target != None and target not in taken: taken.append(target)
+        return taken
+
+    def stack_depth(self, function):
+        '''worst case (hardware, soft) stack bytes of the function and its
+        callees. Indirect jumps may reach any function whose address is taken.'''
+        if function.stack != None: return function.stack
+        if function in self.active: return (0, 0) # recursion
+        self.active.add(function)
+
+        pushed = 0
+        hardware = 0
+        soft = 0
+        for statement in function.statements:
+            instruction = statement.instruction
+            if instruction == 35 or instruction == 36: pushed += 1
+            elif instruction == 37 or instruction == 38: pushed = max(pushed - 1, 0)
+            hardware = max(hardware, pushed)
+
+            callees = []
+            return_address = 0
+            if instruction == 28: # JSR
+                callees = [self.by_addr.get(statement.get_jump_addr())]
+                return_address = 2
+            elif instruction == 27 and statement.address_mode == AddressMode.ind:
+                callees = self.address_taken
+            elif instruction == 27 and not function.contains(statement.get_jump_addr()):
+                callees = [self.by_addr.get(statement.get_jump_addr())] # tail call
+
+            for callee in callees:
+                if callee == None: continue
+                callee_hardware, callee_soft = self.stack_depth(callee)
+                hardware = max(hardware, pushed + return_address + callee_hardware)
+                soft = max(soft, callee_soft)
+
+        self.active.discard(function)
+        function.stack = (hardware, soft_frame_size(function, self.rc_base) + soft)
+        return function.stack
+
+    def call_cycles(self, caller, addr):
+        '''cycles of one pass through the called function'''
+        callee = self.by_addr.get(addr)
+        if callee == None:
+            caller.calls_unknown = True
+            return (0, 0)
+        if callee in self.active: return (0, 0)  # recursion
+        self.analyse_function(callee)
+        return (callee.best, callee.worst)
+
+    def path(self, function, first, last, back_edge):
+        '''(best, worst) cycles from each statement in [first, last] to the
+        exit. back_edge is the index of the loop's backward jump, paths
+        leaving the loop body are dropped. Without a loop, backward jumps
+        end the pass.'''
+
+        statements = function.statements
+        cost = [None] * (last + 2)
+
+        for i in range(last, first - 1, -1):
+            statement = statements[i]
+            next = cost[i + 1] if i < last else (None if back_edge != None else (0, 0))
+            instruction = statement.instruction
+
+            if instruction == None:
+                cost[i] = None if back_edge != None else (0, 0)
+                continue
+
+            if instruction in BranchInstructions:
+                target = function.index.get(statement.get_jump_addr())
+                taken = (branch_taken_cycles(statement),) * 2
+                not_taken = add((2, 2), next)
+                if i == back_edge:
+                    cost[i] = taken
+                elif target != None and i < target <= last:
+                    cost[i] = combine(not_taken, add(taken, cost[target]))
+                elif back_edge != None:
+                    cost[i] = not_taken  # loop exit or inner loop
+                elif target != None and target <= i and not_taken != None:
+                    cost[i] = not_taken  # leave the loop after one pass
+                else:
+                    cost[i] = combine(not_taken, taken)
+                continue
+
+            if instruction == 27: # JMP
+                if statement.address_mode == AddressMode.ind:
+                    cost[i] = None if back_edge != None else (5, 5)
+                    continue
+                addr = statement.get_jump_addr()
+                target = function.index.get(addr)
+                if i == back_edge:
+                    cost[i] = (3, 3)
+                elif target != None and i < target <= last:
+                    cost[i] = add((3, 3), cost[target])
+                elif back_edge != None:
+                    cost[i] = None
+                elif target != None:
+                    cost[i] = (3, 3)
+                else:
+                    cost[i] = add((3, 3), self.call_cycles(function, addr)) # tail call
+                continue
+
+            if instruction == 28: # JSR
+                cost[i] = add(add((6, 6), self.call_cycles(function, statement.get_jump_addr())), next)
+                continue
+
+            if statement.is_return():
+                cost[i] = None if back_edge != None else (6, 6)
+                continue
+
+            cost[i] = add(statement_cycles(statement), next)
+
+        return cost[first]
+
+    def analyse_function(self, function):
+        if function in self.active or function.analysed: return
+        self.active.add(function)
+
+        statements = function.statements
+        for i, statement in enumerate(statements):
+            if statement.instruction == None: continue
+            if statement.instruction in BranchInstructions and branch_crosses_page(statement):
+                function.crossings.append((statement, "branch crosses page, +1 cycle when taken"))
+            elif statement.address_mode in (AddressMode.abx, AddressMode.aby) and indexed_may_cross_page(statement):
+                function.crossings.append((statement, "indexed read may cross page, +1 cycle"))
+
+            if statement.is_jump() and statement.instruction != 28:
+                target = function.index.get(statement.get_jump_addr())
+                if target != None and target <= i:
+                    function.loops.append(Loop(function, target, i))
+
+        for loop in function.loops:
+            cycles = self.path(function, loop.head, loop.tail, loop.tail)
+            if cycles: loop.best, loop.worst = cycles
+            for statement, reason in function.crossings:
+                if statements[loop.head].addr <= statement.addr <= statements[loop.tail].addr:
+                    loop.crossings += 1
+
+        if len(statements) > 0:
+            cycles = self.path(function, 0, len(statements) - 1, None)
+            if cycles: function.best, function.worst = cycles
+
+        self.active.discard(function)
+        function.analysed = True
+
+def demangle(names):
+    '''Demangle C++ names with llvm-cxxfilt or c++filt if available'''
+    import subprocess
+    for tool in ("llvm-cxxfilt", "c++filt"):
+        try:
+            result = subprocess.run([tool], input="\n".join(names), capture_output=True, text=True)
+            lines = result.stdout.splitlines()
+            if result.returncode == 0 and len(lines) == len(names):
+                return dict(zip(names, lines))
+        except OSError:
+            pass
+    return {}
+
+def format_statement(statement, names):
+    opcode_s = InstructionNames[statement.instruction].lower()
+    if statement.is_jump():
+        addr = statement.get_jump_addr()
+        return f"{opcode_s} " + names.get(addr, f"${addr:04x}")
+    if statement.address_mode == AddressMode.abx: return f"{opcode_s} ${statement.get_jump_addr():04x},x"
+    if statement.address_mode == AddressMode.aby: return f"{opcode_s} ${statement.get_jump_addr():04x},y"
+    return opcode_s
+
+def get_functions(binary, load_address, code_address, symbols_file):
+    '''Function boundaries from ELF function symbols, or from the SYS entry,
+    call targets, irq handlers and label file symbols following a return'''
+
+    from bench64 import read_elf_symbols, load_symbols
+
+    program_end = load_address + len(binary) - 2
+    ranges = {}
+
+    if symbols_file:
+        with open(symbols_file, "rb") as in_file:
+            data = in_file.read()
+        if data[:4] == b"\x7fELF":
+            for name, value, size, type, shndx in read_elf_symbols(data):
+                if type != 2 or size == 0: continue    # STT_FUNC
+                if value < code_address or value >= program_end: continue
+                if value not in ranges: ranges[value] = (name, value + size)
+            if len(ranges) > 0: return ranges
+
+    names = {}
+    if symbols_file:
+        for name, value in load_symbols(symbols_file).items():
+            if value not in names: names[value] = name
+
+    entries = { code_address }
+    statements = decode_program(binary, code_address - load_address + 2, len(binary), load_address)
+    previous = None
+    for statement in statements:
+        if statement.instruction == 28 or statement.jump_address != None:
+            entries.add(statement.get_jump_addr())
+        if statement.addr in names and previous != None:
+            if previous.instruction == None or previous.is_return() or previous.instruction == 27:
+                entries.add(statement.addr)   # can't be reached by falling through
+        previous = statement
+
+    entries = sorted(addr for addr in entries if code_address <= addr < program_end)
+    for i, addr in enumerate(entries):
+        end = entries[i + 1] if i + 1 < len(entries) else program_end
+        ranges[addr] = (names.get(addr, f"sub_{addr:04x}"), end)
+
+    return ranges
+
+def get_irq_handlers(functions, binary, load_address, code_address):
+    '''functions returning with RTI or installed by an irq setup sequence'''
+    handlers = [function for function in functions if any(s.instruction == 41 for s in function.statements)]
+    statements = decode_program(binary, code_address - load_address + 2, len(binary), load_address)
+    for statement in statements:
+        if statement.jump_address == None: continue
+        for function in functions:
+            if function.addr == statement.jump_address and function not in handlers:
+                handlers.append(function)
+    return handlers
+
+def analyse(input_file, output_file, binary, options):
+    '''Rank functions and loops by static cycle estimates'''
+
+    from pack64 import get_sys_address
+
+    load_address = int.from_bytes(binary[0:2], 'little')
+    code_address = get_sys_address(binary[2:])
+    if code_address == None:
+        print("no SYS entry found")
+        return
+
+    symbols_file = options.symbols_file
+    if not symbols_file:
+        for candidate in (Path(input_file).with_suffix(".elf"), Path(str(input_file) + ".elf")):
+            if candidate.exists(): symbols_file = candidate
+
+    functions = []
+    for addr, (name, end) in sorted(get_functions(binary, load_address, code_address, symbols_file).items()):
+        function = Function(name, addr, end)
+        function.statements = decode_program(binary, addr - load_address + 2, end - load_address + 2, load_address)
+        for i, statement in enumerate(function.statements):
+            function.index[statement.addr] = i
+        functions.append(function)
+
+    symbols = {}
+    if symbols_file:
+        from bench64 import load_symbols
+        symbols = load_symbols(symbols_file)
+
+    analyser = Analyser(functions, symbols.get("__rc0", 0x02))
+    for function in functions:
+        analyser.analyse_function(function)
+
+    readable = demangle([function.name for function in functions])
+    names = {}
+    for function in functions:
+        names[function.addr] = readable.get(function.name, function.name)
+
+    out_file = None
+    if output_file: out_file = open(output_file, "w")
+
+    top = options.top
+
+    write(out_file, f"; functions by worst case cycles per pass (loop bodies counted once, calls included)")
+    write(out_file, f";  worst   best  bytes loops cross  address  function")
+    ranked = sorted(functions, key=lambda f: (-f.worst, f.addr))
+    for function in ranked[:top]:
+        suffix = " (+ unknown calls)" if function.calls_unknown else ""
+        write(out_file, f"  {function.worst:6} {function.best:6} {function.end - function.addr:6} {len(function.loops):5} {len(function.crossings):5}  ${function.addr:04x}    {names[function.addr]}{suffix}")
+    write(out_file, "")
+
+    loops = [loop for function in functions for loop in function.loops]
+    write(out_file, f"; loops by worst case cycles per iteration")
+    write(out_file, f";  worst   best cross  range        function")
+    for loop in sorted(loops, key=lambda l: (-l.worst, l.function.addr))[:top]:
+        first = loop.function.statements[loop.head].addr
+        last = loop.function.statements[loop.tail].addr
+        write(out_file, f"  {loop.worst:6} {loop.best:6} {loop.crossings:5}  ${first:04x}-${last:04x}  {names[loop.function.addr]}")
+    write(out_file, "")
+
+    entries = [analyser.by_addr[code_address]] if code_address in analyser.by_addr else []
+    # the SYS entry is the main program, even if it also ends with rti (packed programs)
+    irq_handlers = [f for f in get_irq_handlers(functions, binary, load_address, code_address) if f not in entries]
+    write(out_file, f"; worst case stack depth in bytes, including calls (indirect jumps: any function whose address is taken)")
+    write(out_file, f";     hw   soft  address  entry")
+    main_depth = (0, 0)
+    irq_depth = (0, 0)
+    for function in entries:
+        main_depth = analyser.stack_depth(function)
+        write(out_file, f"  {main_depth[0]:6} {main_depth[1]:6}  ${function.addr:04x}    {names[function.addr]}")
+    for function in irq_handlers:
+        hardware, soft = analyser.stack_depth(function)
+        hardware += 3   # return address and status pushed by the interrupt
+        irq_depth = (max(irq_depth[0], hardware), max(irq_depth[1], soft))
+        write(out_file, f"  {hardware:6} {soft:6}  ${function.addr:04x}    {names[function.addr]} (irq)")
+    if irq_handlers:
+        write(out_file, f"; with an irq on top of the deepest main program call: {main_depth[0] + irq_depth[0]} bytes hardware stack, {main_depth[1] + irq_depth[1]} bytes soft stack")
+    write(out_file, "")
+
+    write(out_file, f"; page crossings")
+    for function in functions:
+        for statement, reason in function.crossings:
+            in_loop = any(l.function.statements[l.head].addr <= statement.addr <= l.function.statements[l.tail].addr for l in function.loops)
+            marker = "*" if in_loop else " "
+            write(out_file, f" {marker}${statement.addr:04x}  {format_statement(statement, names):22}  {reason}  ({names[function.addr]})")
+    write(out_file, "")
+    write(out_file, "; * inside a loop")
+
+    if out_file: out_file.close()
+
 def monitor(source, dest, show_binary):
     sz = 0
     tm = 0.0
@@ -894,7 +1331,7 @@ def monitor(source, dest, show_binary):
 def main():
     '''Main entry'''
     try:
-        opts, args = getopt.getopt(sys.argv[1:], "h:mbc", ["help", "monitor", "nobinary", "nocomments"])
+        opts, args = getopt.getopt(sys.argv[1:], "h:mbcas:n:", ["help", "monitor", "nobinary", "nocomments", "analyse", "symbols=", "top="])
     except getopt.GetoptError:
         usage()
         sys.exit(2)
@@ -917,6 +1354,12 @@ def main():
             options.show_binary = False
         elif o in ("-c", "--nocomments"):
             options.show_comments = False
+        elif o in ("-a", "--analyse"):
+            options.analyse = True
+        elif o in ("-s", "--symbols"):
+            options.symbols_file = a
+        elif o in ("-n", "--top"):
+            options.top = int(a)
 
     source = Path(args[0])
 
@@ -13,12 +13,20 @@ VERBOSE = False
 MAX_LINE_LENGTH = 120
 HEXCHARS = "0123456789abcdef"
 
+D64_SIZE = 174848
+D64_TRACKS = 35
+DIR_TRACK = 18
+FILE_INTERLEAVE = 10
+DIR_INTERLEAVE = 3
+
 def usage():
-    print("Usage: disk64 [-l|--list] [-e|--export] DISK.D64 [FILENAME]")
+    print("Usage: disk64 [-l|--list] [-e|--export] [-c|--create] [-a|--add] DISK.D64 [FILENAME...]")
     print("")
     print("DISK.D64          : C64 disk file")
     print("-l, --list        : List directory")
     print("-e, --export      : Export file from disk")
+    print("-c, --create      : Create new disk and add files")
+    print("-a, --add         : Add files to disk (.prg files as is, others with load address $0000)")
 
 def get_sectors_of_track(track_number):
     if track_number < 17:
@@ -59,6 +67,17 @@ def petscii_to_ascii(c):
         return ord('A') + c - 65
     return c
 
+def ascii_to_petscii(c):
+    if ord('a') <= c <= ord('z'):
+        return c - ord('a') + 65
+    return c
+
+def encode_name(name, max_len=16):
+    data = bytearray([0xa0] * max_len)
+    for i, c in enumerate(name.encode("ascii")[:max_len]):
+        data[i] = ascii_to_petscii(c)
+    return data
+
 def get(data, pos):
     sz = len(data)
     if pos >= sz:
@@ -141,7 +160,7 @@ class DirectoryEntry:
         return type_name
 
 class Disk:
-    def __init__(self, filename):
+    def __init__(self, filename, create=False):
         self.filename = None
         self.disk = None
         self.disk_format = None
@@ -152,7 +171,10 @@ class Disk:
         self.disk_id = None
         self.directory = []
 
-        self.open(filename)
+        if create:
+            self.create(filename)
+        else:
+            self.open(filename)
         self.read_directory()
 
     def open(self, filename):
@@ -164,10 +186,166 @@ class Disk:
         # standard .64 is 174848 bytes
         self.disk = None
         with open(filename, "rb") as in_file:
-            self.disk = in_file.read()
+            self.disk = bytearray(in_file.read())
+
+        self.filename = filename
 
+    def create(self, filename, disk_name=None, disk_id="01"):
+
+        disk = bytearray(D64_SIZE)
+
+        bam = get_track_offset(DIR_TRACK-1)
+        disk[bam+0] = DIR_TRACK
+        disk[bam+1] = 1
+        disk[bam+2] = 0x41  # "A"
+        disk[bam+3] = 0x00
+
+        for track_number in range(1, D64_TRACKS+1):
+            num_sectors = get_sectors_of_track(track_number-1)
+            bits = (1 << num_sectors) - 1
+            ofs = bam + 4 + (track_number-1) * 4
+            disk[ofs+0] = num_sectors
+            disk[ofs+1] = bits & 0xff
+            disk[ofs+2] = (bits >> 8) & 0xff
+            disk[ofs+3] = (bits >> 16) & 0xff
+
+        if not disk_name: disk_name = Path(filename).stem
+        disk[bam+0x90:bam+0xa0] = encode_name(disk_name)
+        disk[bam+0xa0] = 0xa0
+        disk[bam+0xa1] = 0xa0
+        disk[bam+0xa2:bam+0xa4] = encode_name(disk_id, 2)
+        disk[bam+0xa4] = 0xa0
+        disk[bam+0xa5] = 0x32  # "2"
+        disk[bam+0xa6] = 0x41  # "A"
+        disk[bam+0xa7:bam+0xab] = bytes([0xa0] * 4)
+
+        # first directory sector
+        dir_ofs = get_track_offset(DIR_TRACK-1) + 256
+        disk[dir_ofs+0] = 0x00
+        disk[dir_ofs+1] = 0xff
+
+        self.disk = disk
         self.filename = filename
 
+        self.allocate_sector(DIR_TRACK, 0)
+        self.allocate_sector(DIR_TRACK, 1)
+
+    def save(self, filename=None):
+        if not filename: filename = self.filename
+        with open(filename, "wb") as out_file:
+            out_file.write(self.disk)
+
+    def is_sector_free(self, track_number, sector):
+        ofs = get_track_offset(DIR_TRACK-1) + 4 + (track_number-1) * 4
+        return (self.disk[ofs + 1 + (sector >> 3)] & (1 << (sector & 7))) != 0
+
+    def allocate_sector(self, track_number, sector):
+        ofs = get_track_offset(DIR_TRACK-1) + 4 + (track_number-1) * 4
+        self.disk[ofs + 1 + (sector >> 3)] &= ~(1 << (sector & 7)) & 0xff
+        self.disk[ofs] -= 1
+
+    def find_free_sector(self, track_number, sector, interleave):
+        num_sectors = get_sectors_of_track(track_number-1)
+        for i in range(num_sectors):
+            s = (sector + interleave + i) % num_sectors
+            if self.is_sector_free(track_number, s):
+                return s
+        return None
+
+    def next_sector(self, track_number, sector):
+        # allocation order like CBM DOS: tracks next to the directory first
+        track_order = []
+        for dist in range(1, D64_TRACKS):
+            if DIR_TRACK - dist >= 1: track_order.append(DIR_TRACK - dist)
+            if DIR_TRACK + dist <= D64_TRACKS: track_order.append(DIR_TRACK + dist)
+
+        if track_number is not None:
+            s = self.find_free_sector(track_number, sector, FILE_INTERLEAVE)
+            if s is not None:
+                return track_number, s
+
+        for t in track_order:
+            s = self.find_free_sector(t, 0, 0)
+            if s is not None:
+                return t, s
+
+        return None, None
+
+    def sector_offset(self, track_number, sector):
+        return get_track_offset(track_number-1) + sector * 256
+
+    def add_directory_entry(self, name, file_type, track_number, sector, num_blocks):
+        disk = self.disk
+        dir_track = DIR_TRACK
+        dir_sector = 1
+
+        while True:
+            sector_ofs = self.sector_offset(dir_track, dir_sector)
+            for entry in range(0, 8):
+                ofs = sector_ofs + entry * 0x20
+                if disk[ofs+2] == 0x00:
+                    disk[ofs+2] = 0x80 | file_type  # closed file
+                    disk[ofs+3] = track_number
+                    disk[ofs+4] = sector
+                    disk[ofs+5:ofs+21] = encode_name(name)
+                    disk[ofs+30] = num_blocks & 0xff
+                    disk[ofs+31] = num_blocks >> 8
+                    return True
+
+            if disk[sector_ofs] == 0:
+                new_sector = self.find_free_sector(DIR_TRACK, dir_sector, DIR_INTERLEAVE)
+                if new_sector is None:
+                    return False
+                self.allocate_sector(DIR_TRACK, new_sector)
+                disk[sector_ofs+0] = DIR_TRACK
+                disk[sector_ofs+1] = new_sector
+                new_ofs = self.sector_offset(DIR_TRACK, new_sector)
+                disk[new_ofs:new_ofs+256] = bytes(256)
+                disk[new_ofs+1] = 0xff
+
+            dir_track = disk[sector_ofs]
+            dir_sector = disk[sector_ofs+1]
+
+    def write_file(self, name, data, file_type=FileType.Prg):
+        disk = self.disk
+
+        if self.find_file(name.upper()):
+            print(f"file exists: {name}")
+            return False
+
+        num_blocks = max(1, (len(data) + 253) // 254)
+        if num_blocks > self.free_blocks:
+            print(f"disk full: {name}")
+            return False
+
+        sectors = []
+        track_number, sector = None, 0
+        for i in range(num_blocks):
+            track_number, sector = self.next_sector(track_number, sector)
+            self.allocate_sector(track_number, sector)
+            sectors.append((track_number, sector))
+
+        for i, (track_number, sector) in enumerate(sectors):
+            ofs = self.sector_offset(track_number, sector)
+            chunk = data[i*254:(i+1)*254]
+            disk[ofs:ofs+256] = bytes(256)
+            if i < len(sectors) - 1:
+                disk[ofs+0] = sectors[i+1][0]
+                disk[ofs+1] = sectors[i+1][1]
+            else:
+                disk[ofs+0] = 0
+                disk[ofs+1] = len(chunk) + 1
+            disk[ofs+2:ofs+2+len(chunk)] = chunk
+
+        if not self.add_directory_entry(name, file_type, sectors[0][0], sectors[0][1], num_blocks):
+            print(f"directory full: {name}")
+            return False
+
+        self.directory = []
+        self.read_directory()
+
+        return True
+
     def decode_name(self, ofs, max_len):
         name = ""
         for i in range(0, max_len):
@@ -260,7 +438,7 @@ class Disk:
 
             entry_ofs = 0
 
-            for entry in range(0, 7):
+            for entry in range(0, 8):
 
                 ofs = sector_ofs + entry * 0x20
 
@@ -310,10 +488,10 @@ class Disk:
 
                     self.directory.append(directory_entry)
 
-            if next_track == 0 or next_sector == 0:
+            if next_track == 0:
                 break
 
-            track = next_track
+            track = next_track - 1
             sector = next_sector
 
     def list(self, pattern=None):
@@ -393,11 +571,31 @@ def export(disk_filename, filename):
     with open("export.prg", "wb") as out_file:
         out_file.write(file_data)
 
+def add_files(disk_filename, filenames, create=False):
+    disk = Disk(disk_filename, create)
+    for filename in filenames:
+        filename = Path(filename)
+        if not filename.exists() or not os.path.isfile(filename):
+            print(f"{filename} does not exist or is invalid")
+            sys.exit(1)
+
+        with open(filename, "rb") as in_file:
+            data = in_file.read()
+
+        if filename.suffix.lower() != ".prg":
+            data = bytes([0x00, 0x00]) + data  # load address
+
+        if not disk.write_file(filename.stem, data):
+            sys.exit(1)
+
+    disk.save(disk_filename)
+    disk.list()
+
 def main():
     '''Main entry'''
     try:
-        opts, args = getopt.getopt(sys.argv[1:], "h:le", [
-                                   "help", "list", "export"])
+        opts, args = getopt.getopt(sys.argv[1:], "h:leca", [
+                                   "help", "list", "export", "create", "add"])
     except getopt.GetoptError:
         usage()
         sys.exit(2)
@@ -408,6 +606,8 @@ def main():
 
     opt_show_dir = False
     opt_export = False
+    opt_create = False
+    opt_add = False
 
     for o, a in opts:
         if o in ("-h", "--help"):
@@ -417,8 +617,17 @@ def main():
             opt_show_dir = True
         elif o in ("-e", "--export"):
             opt_export = True
+        elif o in ("-c", "--create"):
+            opt_create = True
+        elif o in ("-a", "--add"):
+            opt_add = True
 
     disk_filename = Path(args[0])
+
+    if opt_create:
+        add_files(disk_filename, args[1:], True)
+        return
+
     if not disk_filename.exists or not os.path.isfile(disk_filename):
         print(f"{disk_filename} does not exist or is invalid")
         sys.exit(1)
@@ -428,6 +637,8 @@ def main():
     elif opt_export:
         filename = args[1]
         export(disk_filename, filename)
+    elif opt_add:
+        add_files(disk_filename, args[1:])
 
 if __name__ == "__main__":
     main()
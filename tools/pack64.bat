@@ -0,0 +1,13 @@
+@ECHO OFF
+
+REM #
+REM # pack64 - LZ4 packer for C64 resources
+REM # (C) Roland Schabenberger
+REM #
+
+SETLOCAL
+PUSHD %~dp0
+SET SCRIPT_DIR=%CD%
+POPD
+python %SCRIPT_DIR%\pack64.py %1 %2 %3 %4 %5 %6 %7 %8
+ENDLOCAL
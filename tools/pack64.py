@@ -0,0 +1,481 @@
+#
+# pack64 - LZ4 packer for C64 resources
+# (C) Roland Schabenberger
+#
+
+import sys
+import os
+import os.path
+import getopt
+from pathlib import Path
+
+MAX_LINE_LENGTH = 120
+HEXCHARS = "0123456789abcdef"
+
+MIN_MATCH = 4
+LAST_LITERALS = 5       # LZ4 end of block: the last 5 bytes are literals,
+MATCH_LIMIT = 12        # the last match starts at least 12 bytes before the end
+MAX_OFFSET = 0xffff
+MAX_CHAIN = 256
+
+BASIC_START = 0x0801
+SFX_MOVER_ADDRESS = 0x080d
+SFX_DEPACKER_ADDRESS = 0xcf00   # packed data is moved to end right below
+
+# BASIC stub: 10 SYS2061
+SFX_BASIC_STUB = [0x0b, 0x08, 0x0a, 0x00, 0x9e, 0x32, 0x30, 0x36, 0x31, 0x00, 0x00, 0x00]
+
+# Self-extracting stub, part 1 (at $080d): moves packed data and
+# depacker to the top of memory (copying backwards) and jumps
+# to the depacker. Zero page $fb-$fe is used as pointers.
+SFX_MOVER = [
+    ([0x78],                  "sei"),
+    ([0xa9, 0x34],            "lda #$34"),
+    ([0x85, 0x01],            "sta $01"),
+    ([0xa9, "<SRC_START"],    "lda #<SRC_START"),
+    ([0x85, 0xfb],            "sta $fb"),
+    ([0xa9, ">SRC_START"],    "lda #>SRC_START"),
+    ([0x85, 0xfc],            "sta $fc"),
+    ([0xa9, "<DST_START"],    "lda #<DST_START"),
+    ([0x85, 0xfd],            "sta $fd"),
+    ([0xa9, ">DST_START"],    "lda #>DST_START"),
+    ([0x85, 0xfe],            "sta $fe"),
+    ([0xa2, ">MOVE_SIZE"],    "ldx #>MOVE_SIZE"),
+    ([0x18],                  "clc"),
+    ([0x8a],                  "txa"),
+    ([0x65, 0xfc],            "adc $fc"),
+    ([0x85, 0xfc],            "sta $fc"),
+    ([0x18],                  "clc"),
+    ([0x8a],                  "txa"),
+    ([0x65, 0xfe],            "adc $fe"),
+    ([0x85, 0xfe],            "sta $fe"),
+    ([0xe8],                  "inx"),
+    ([0xa0, "<MOVE_SIZE"],    "ldy #<MOVE_SIZE"),
+    ([0xf0, 0x0e],            "beq mu3"),
+    ([0x88],                  "dey"),
+    ([0xf0, 0x07],            "beq mu2"),
+    ([0xb1, 0xfb],            "mu1: lda ($fb),y"),
+    ([0x91, 0xfd],            "sta ($fd),y"),
+    ([0x88],                  "dey"),
+    ([0xd0, 0xf9],            "bne mu1"),
+    ([0xb1, 0xfb],            "mu2: lda ($fb),y"),
+    ([0x91, 0xfd],            "sta ($fd),y"),
+    ([0x88],                  "mu3: dey"),
+    ([0xc6, 0xfc],            "dec $fc"),
+    ([0xc6, 0xfe],            "dec $fe"),
+    ([0xca],                  "dex"),
+    ([0xd0, 0xed],            "bne mu1"),
+    ([0x4c, 0x00, 0xcf],      "jmp $cf00"),
+]
+
+# Self-extracting stub, part 2 (at $cf00): LZ4 depacker, unpacks
+# in-place to $0801 until the packed data end ($cf00) is reached,
+# then restores memory configuration and starts the program.
+# Zero page $02, $f7-$fe is used.
+SFX_DEPACKER = [
+    ([0xa9, "<PACKED"],       "lda #<PACKED"),
+    ([0x85, 0xfb],            "sta $fb"),
+    ([0xa9, ">PACKED"],       "lda #>PACKED"),
+    ([0x85, 0xfc],            "sta $fc"),
+    ([0xa9, "<DEST"],         "lda #<DEST"),
+    ([0x85, 0xfd],            "sta $fd"),
+    ([0xa9, ">DEST"],         "lda #>DEST"),
+    ([0x85, 0xfe],            "sta $fe"),
+    ([0x20, 0x8a, 0xcf],      "loop: jsr getbyte"),
+    ([0x85, 0x02],            "sta $02"),
+    ([0x4a],                  "lsr a"),
+    ([0x4a],                  "lsr a"),
+    ([0x4a],                  "lsr a"),
+    ([0x4a],                  "lsr a"),
+    ([0xf0, 0x16],            "beq nolit"),
+    ([0x20, 0x6e, 0xcf],      "jsr getlen"),
+    ([0xa5, 0xfb],            "lda $fb"),
+    ([0x85, 0xf7],            "sta $f7"),
+    ([0xa5, 0xfc],            "lda $fc"),
+    ([0x85, 0xf8],            "sta $f8"),
+    ([0x20, 0x95, 0xcf],      "jsr copy"),
+    ([0xa5, 0xf7],            "lda $f7"),
+    ([0x85, 0xfb],            "sta $fb"),
+    ([0xa5, 0xf8],            "lda $f8"),
+    ([0x85, 0xfc],            "sta $fc"),
+    ([0xa5, 0xfc],            "nolit: lda $fc"),
+    ([0xc9, 0xcf],            "cmp #>$cf00"),
+    ([0xf0, 0x2f],            "beq done"),
+    ([0x20, 0x8a, 0xcf],      "jsr getbyte"),
+    ([0x85, 0xf7],            "sta $f7"),
+    ([0x20, 0x8a, 0xcf],      "jsr getbyte"),
+    ([0x85, 0xf8],            "sta $f8"),
+    ([0x38],                  "sec"),
+    ([0xa5, 0xfd],            "lda $fd"),
+    ([0xe5, 0xf7],            "sbc $f7"),
+    ([0x85, 0xf7],            "sta $f7"),
+    ([0xa5, 0xfe],            "lda $fe"),
+    ([0xe5, 0xf8],            "sbc $f8"),
+    ([0x85, 0xf8],            "sta $f8"),
+    ([0xa5, 0x02],            "lda $02"),
+    ([0x29, 0x0f],            "and #$0f"),
+    ([0x20, 0x6e, 0xcf],      "jsr getlen"),
+    ([0x18],                  "clc"),
+    ([0xa5, 0xf9],            "lda $f9"),
+    ([0x69, 0x04],            "adc #4"),
+    ([0x85, 0xf9],            "sta $f9"),
+    ([0x90, 0x02],            "bcc match"),
+    ([0xe6, 0xfa],            "inc $fa"),
+    ([0x20, 0x95, 0xcf],      "match: jsr copy"),
+    ([0x4c, 0x10, 0xcf],      "jmp loop"),
+    ([0xa9, 0x37],            "done: lda #$37"),
+    ([0x85, 0x01],            "sta $01"),
+    ([0x58],                  "cli"),
+    ([0x4c, "START"],         "jmp START"),
+    ([0x85, 0xf9],            "getlen: sta $f9"),
+    ([0xa2, 0x00],            "ldx #0"),
+    ([0x86, 0xfa],            "stx $fa"),
+    ([0xc9, 0x0f],            "cmp #15"),
+    ([0xd0, 0x11],            "bne gl3"),
+    ([0x20, 0x8a, 0xcf],      "gl1: jsr getbyte"),
+    ([0xaa],                  "tax"),
+    ([0x18],                  "clc"),
+    ([0x65, 0xf9],            "adc $f9"),
+    ([0x85, 0xf9],            "sta $f9"),
+    ([0x90, 0x02],            "bcc gl2"),
+    ([0xe6, 0xfa],            "inc $fa"),
+    ([0xe0, 0xff],            "gl2: cpx #255"),
+    ([0xf0, 0xef],            "beq gl1"),
+    ([0x60],                  "gl3: rts"),
+    ([0xa0, 0x00],            "getbyte: ldy #0"),
+    ([0xb1, 0xfb],            "lda ($fb),y"),
+    ([0xe6, 0xfb],            "inc $fb"),
+    ([0xd0, 0x02],            "bne gb1"),
+    ([0xe6, 0xfc],            "inc $fc"),
+    ([0x60],                  "gb1: rts"),
+    ([0xa0, 0x00],            "copy: ldy #0"),
+    ([0xa6, 0xfa],            "ldx $fa"),
+    ([0xf0, 0x0e],            "beq cp2"),
+    ([0xb1, 0xf7],            "cp1: lda ($f7),y"),
+    ([0x91, 0xfd],            "sta ($fd),y"),
+    ([0xc8],                  "iny"),
+    ([0xd0, 0xf9],            "bne cp1"),
+    ([0xe6, 0xf8],            "inc $f8"),
+    ([0xe6, 0xfe],            "inc $fe"),
+    ([0xca],                  "dex"),
+    ([0xd0, 0xf2],            "bne cp1"),
+    ([0xa6, 0xf9],            "cp2: ldx $f9"),
+    ([0xf0, 0x1c],            "beq cp4"),
+    ([0xb1, 0xf7],            "cp3: lda ($f7),y"),
+    ([0x91, 0xfd],            "sta ($fd),y"),
+    ([0xc8],                  "iny"),
+    ([0xca],                  "dex"),
+    ([0xd0, 0xf8],            "bne cp3"),
+    ([0x98],                  "tya"),
+    ([0x18],                  "clc"),
+    ([0x65, 0xf7],            "adc $f7"),
+    ([0x85, 0xf7],            "sta $f7"),
+    ([0x90, 0x02],            "bcc cp5"),
+    ([0xe6, 0xf8],            "inc $f8"),
+    ([0x98],                  "cp5: tya"),
+    ([0x18],                  "clc"),
+    ([0x65, 0xfd],            "adc $fd"),
+    ([0x85, 0xfd],            "sta $fd"),
+    ([0x90, 0x02],            "bcc cp4"),
+    ([0xe6, 0xfe],            "inc $fe"),
+    ([0x60],                  "cp4: rts"),
+]
+
+def usage():
+    print("Usage: pack64 [-c] [-n NAME] [-s] [-x] INFILE OUTFILE")
+    print("")
+    print("INFILE            : Input file (raw binary, SpritePad .spd or .prg)")
+    print("OUTFILE           : Packed output file")
+    print("-c, --cpp         : Write C++ source instead of binary")
+    print("-n, --name        : Symbol name for C++ output")
+    print("-s, --sprites     : Extract sprite data from SpritePad .spd file")
+    print("-x, --sfx         : Create self-extracting .prg from BASIC .prg file")
+
+def format_byte(value):
+    return "0x" + HEXCHARS[int(value/16)] + HEXCHARS[int(value%16)]
+
+def read_spd_sprites(data):
+    '''Extract sprite data (64 bytes per sprite) from SpritePad file'''
+    if len(data) < 16 or data[0:3] != b"SPD":
+        print("invalid SpritePad file")
+        sys.exit(1)
+
+    header_size = 16
+    num_sprites = (data[5] | (data[6] << 8))
+    available = (len(data) - header_size) // 64
+    num_sprites = min(num_sprites, available)
+
+    return data[header_size:header_size + num_sprites * 64]
+
+def write_length(out, length):
+    while length >= 255:
+        out.append(255)
+        length -= 255
+    out.append(length)
+
+def emit_sequence(out, literals, match_len, offset):
+    lit_len = len(literals)
+    token = (min(lit_len, 15) << 4)
+    if match_len > 0:
+        token |= min(match_len - MIN_MATCH, 15)
+    out.append(token)
+    if lit_len >= 15: write_length(out, lit_len - 15)
+    out.extend(literals)
+    if match_len > 0:
+        out.append(offset & 0xff)
+        out.append(offset >> 8)
+        if match_len - MIN_MATCH >= 15: write_length(out, match_len - MIN_MATCH - 15)
+
+def compress(data):
+    '''LZ4 block compression (greedy, hash chains)'''
+    out = bytearray()
+    chains = {}
+    sequences = []  # (input pos after sequence, output pos after sequence) for in-place margin
+
+    size = len(data)
+    pos = 0
+    literal_start = 0
+    match_end = size - LAST_LITERALS    # so the block always ends with a literal run
+
+    def insert(p):
+        if p + MIN_MATCH <= size:
+            key = bytes(data[p:p+MIN_MATCH])
+            chains.setdefault(key, []).append(p)
+
+    while pos < size:
+        best_len = 0
+        best_ofs = 0
+        if pos + MATCH_LIMIT <= size:
+            key = bytes(data[pos:pos+MIN_MATCH])
+            candidates = chains.get(key, [])
+            for cand in reversed(candidates[-MAX_CHAIN:]):
+                ofs = pos - cand
+                if ofs > MAX_OFFSET: break
+                length = 0
+                while pos + length < match_end and data[cand + length] == data[pos + length]:
+                    length += 1
+                if length > best_len:
+                    best_len = length
+                    best_ofs = ofs
+
+        if best_len >= MIN_MATCH:
+            emit_sequence(out, data[literal_start:pos], best_len, best_ofs)
+            for p in range(pos, pos + best_len): insert(p)
+            pos += best_len
+            literal_start = pos
+            sequences.append((len(out), pos))
+        else:
+            insert(pos)
+            pos += 1
+
+    if literal_start < size or size == 0:
+        emit_sequence(out, data[literal_start:size], 0, 0)
+        sequences.append((len(out), size))
+
+    return out, sequences
+
+def get_inplace_margin(unpacked_size, packed_size, sequences):
+    '''Bytes needed after the unpacked data for in-place decompression'''
+    margin = 0
+    for in_pos, out_pos in sequences:
+        # packed data starts at unpacked_size + margin - packed_size,
+        # output must not overtake the input read position
+        needed = out_pos - in_pos - unpacked_size + packed_size
+        if needed > margin: margin = needed
+    return margin
+
+def assemble_stub(stub, symbols):
+    '''Resolve symbol references ("<SYM", ">SYM", "SYM") in stub code'''
+    code = bytearray()
+    for data, _ in stub:
+        for item in data:
+            if isinstance(item, int):
+                code.append(item)
+            elif item[0] == "<":
+                code.append(symbols[item[1:]] & 0xff)
+            elif item[0] == ">":
+                code.append(symbols[item[1:]] >> 8)
+            else:
+                code.append(symbols[item] & 0xff)
+                code.append(symbols[item] >> 8)
+    return code
+
+def get_sys_address(data):
+    '''Get start address from SYS statement of the first BASIC line'''
+    pos = 4
+    while pos < len(data) and data[pos] != 0x00:
+        if data[pos] == 0x9e:
+            pos += 1
+            while pos < len(data) and data[pos] == 0x20: pos += 1
+            digits = ""
+            while pos < len(data) and 0x30 <= data[pos] <= 0x39:
+                digits += chr(data[pos])
+                pos += 1
+            if len(digits) > 0: return int(digits)
+            break
+        pos += 1
+    return None
+
+def pack_sfx(input_file, output_file):
+    '''Create self-extracting program'''
+
+    with open(input_file, "rb") as in_file:
+        prg = in_file.read()
+
+    if len(prg) < 3 or (prg[0] | (prg[1] << 8)) != BASIC_START:
+        print(f"program does not load to ${BASIC_START:04x}")
+        sys.exit(1)
+
+    data = prg[2:]
+    start = get_sys_address(data)
+    if start is None:
+        print("could not find SYS start address")
+        sys.exit(1)
+
+    block, sequences = compress(data)
+    margin = get_inplace_margin(len(data), len(block), sequences)
+
+    if BASIC_START + len(data) + margin > SFX_DEPACKER_ADDRESS:
+        print(f"program too large for self-extraction (end ${BASIC_START + len(data):04x} + margin {margin})")
+        sys.exit(1)
+
+    mover_size = len(assemble_stub(SFX_MOVER, { "SRC_START": 0, "DST_START": 0, "MOVE_SIZE": 0 }))
+    src_start = SFX_MOVER_ADDRESS + mover_size
+    dst_start = SFX_DEPACKER_ADDRESS - len(block)
+    if dst_start < src_start:
+        print("packed data too large for self-extraction")
+        sys.exit(1)
+
+    depacker = assemble_stub(SFX_DEPACKER, {
+        "PACKED": dst_start,
+        "DEST": BASIC_START,
+        "START": start
+    })
+
+    mover = assemble_stub(SFX_MOVER, {
+        "SRC_START": src_start,
+        "DST_START": dst_start,
+        "MOVE_SIZE": len(block) + len(depacker)
+    })
+
+    sfx = bytearray([BASIC_START & 0xff, BASIC_START >> 8])
+    sfx.extend(SFX_BASIC_STUB)
+    sfx.extend(mover)
+    sfx.extend(block)
+    sfx.extend(depacker)
+
+    print(f"input: {input_file}")
+    print(f"start address: ${start:04x}")
+    print(f"unpacked size: {len(prg)} bytes")
+    print(f"packed size: {len(sfx)} bytes ({100.0 * len(sfx) / len(prg):.1f}%, stub {len(sfx) - len(block) - 2} bytes)")
+    print(f"in-place margin: {margin} bytes")
+
+    if not output_file: return
+
+    with open(output_file, "wb") as out_file:
+        out_file.write(sfx)
+
+def write_cpp(filename, name, source, packed):
+    with open(filename, "w") as out_file:
+        out_file.write("// *****************************************************************************\n")
+        out_file.write(f"// Packed data: {source}\n")
+        out_file.write("// @generated by pack64\n")
+        out_file.write("// *****************************************************************************\n")
+        out_file.write("\n")
+        out_file.write("#include <cstddef>\n")
+        out_file.write("#include <cstdint>\n")
+        out_file.write("\n")
+        out_file.write(f"extern const uint8_t {name}[] = {{\n")
+
+        line = "  "
+        for i in range(len(packed)):
+            line += format_byte(packed[i])
+            if i < len(packed) - 1: line += ","
+            if i == len(packed) - 1 or len(line) >= MAX_LINE_LENGTH:
+                out_file.write(line + "\n")
+                line = "  "
+
+        out_file.write("};\n")
+        out_file.write("\n")
+        out_file.write(f"extern const size_t {name}_size = {len(packed)};\n")
+
+def pack(input_file, output_file, cpp=False, name=None, sprites=False):
+
+    with open(input_file, "rb") as in_file:
+        data = in_file.read()
+
+    if sprites:
+        data = read_spd_sprites(data)
+
+    if len(data) > 0xffff:
+        print("input too large")
+        sys.exit(1)
+
+    block, sequences = compress(data)
+
+    packed = bytearray()
+    packed.append(len(data) & 0xff)
+    packed.append(len(data) >> 8)
+    packed.extend(block)
+
+    margin = get_inplace_margin(len(data), len(packed), sequences)
+
+    print(f"input: {input_file}")
+    print(f"unpacked size: {len(data)} bytes")
+    print(f"packed size: {len(packed)} bytes ({100.0 * len(packed) / max(len(data), 1):.1f}%)")
+    print(f"in-place margin: {margin} bytes")
+
+    if not output_file: return
+
+    if cpp:
+        if not name: name = Path(input_file).stem + "_packed"
+        write_cpp(output_file, name, Path(input_file).name, packed)
+    else:
+        with open(output_file, "wb") as out_file:
+            out_file.write(packed)
+
+def main():
+    '''Main entry'''
+    try:
+        opts, args = getopt.getopt(sys.argv[1:], "hcn:sx", ["help", "cpp", "name=", "sprites", "sfx"])
+    except getopt.GetoptError:
+        usage()
+        sys.exit(2)
+
+    if len(args) < 1:
+        usage()
+        sys.exit()
+
+    cpp = False
+    name = None
+    sprites = False
+    sfx = False
+
+    for o, a in opts:
+        if o in ("-h", "--help"):
+            usage()
+            sys.exit()
+        elif o in ("-c", "--cpp"):
+            cpp = True
+        elif o in ("-n", "--name"):
+            name = a
+        elif o in ("-s", "--sprites"):
+            sprites = True
+        elif o in ("-x", "--sfx"):
+            sfx = True
+
+    source = Path(args[0])
+    if not source.exists() or not os.path.isfile(source):
+        print(f"{source} does not exist or is invalid")
+        sys.exit(3)
+
+    dest = None
+    if len(args) >= 2: dest = Path(args[1])
+
+    if sfx:
+        pack_sfx(source, dest)
+    else:
+        pack(source, dest, cpp, name, sprites)
+
+if __name__ == "__main__":
+    main()
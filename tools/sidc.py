@@ -11,9 +11,14 @@ import os.path
 import getopt
 from pathlib import Path
 
+from dis64 import get_opcode_map, AddressMode, InstructionNames
+
 VERBOSE = False
 
 MAX_LINE_LENGTH = 120
+
+# symbol and section name prefix, fixed: libcpp64 (audio.cpp) and link.ld use these names
+NAME = "music"
 HEXCHARS = "0123456789abcdef"
 
 sid = None
@@ -21,10 +26,13 @@ sid_ofs = 0
 sid_size = 0
 
 def usage():
-    print("Usage: sidc SIDFILE CPPFILE")
+    print("Usage: sidc [-s] [-l LDFILE] SIDFILE CPPFILE")
     print("")
-    print("SIDFILE : C64 SID music file")
-    print("CPPFILE : C++ output file")
+    print("SIDFILE           : C64 SID music file")
+    print("CPPFILE           : C++ output file")
+    print("-l, --linker      : Linker script fragment placing the data at its load address,")
+    print("                    also defines the player's lowest zero page address")
+    print("-s, --shadow      : Redirect player writes to SID registers into the audio shadow buffer")
 
 def format_byte(value):
     return "0x" + HEXCHARS[int(value/16)] + HEXCHARS[int(value%16)]
@@ -59,9 +67,86 @@ def show(label, num_bytes, show_hex=True, show_dec=True):
     print(s)
     return v
 
-def sidc(sid_file, output_file):
+def trace_code(data, load_address, entry_points):
+    '''Decode the instructions reachable from the entry points, returns {offset: (opcode, mode, operand)}'''
+    OpcodeMap = get_opcode_map()
+    operand_sizes = {
+        AddressMode.imp: 0, AddressMode.acc: 0,
+        AddressMode.imm: 1, AddressMode.zp: 1, AddressMode.zpx: 1, AddressMode.zpy: 1,
+        AddressMode.izx: 1, AddressMode.izy: 1, AddressMode.rel: 1,
+        AddressMode.abs: 2, AddressMode.abx: 2, AddressMode.aby: 2, AddressMode.ind: 2
+    }
+    # JMP (ind), RTS, RTI, BRK: no known successor
+    stop_opcodes = [ 0x6c, 0x60, 0x40, 0x00 ]
+
+    code = {}
+    visited = set()
+    todo = list(entry_points)
+    while todo:
+        addr = todo.pop()
+        while addr not in visited:
+            ofs = addr - load_address
+            if ofs < 0 or ofs >= len(data): break
+            opcode_info = OpcodeMap.get(data[ofs])
+            if not opcode_info or InstructionNames[opcode_info[1]] == "JAM": break
+            visited.add(addr)
+
+            mode = opcode_info[2]
+            size = 1 + operand_sizes[mode]
+            if ofs + size > len(data): break
+            operand = int.from_bytes(data[ofs+1:ofs+size], 'little')
+            code[ofs] = (data[ofs], mode, operand)
+
+            if mode == AddressMode.rel:
+                todo.append(addr + size + (operand - 0x100 if operand >= 0x80 else operand))
+
+            if data[ofs] == 0x20: todo.append(operand)  # JSR
+            if data[ofs] == 0x4c:                       # JMP abs
+                addr = operand
+                continue
+            if data[ofs] in stop_opcodes: break
+            addr += size
+
+    return code
+
+def find_sid_writes(code):
+    '''Find absolute (indexed) store instructions to SID registers $d400-$d418'''
+    # STA abs, STX abs, STY abs, STA abs,X, STA abs,Y
+    store_opcodes = [ 0x8d, 0x8e, 0x8c, 0x9d, 0x99 ]
+    patches = {}
+    for ofs, (opcode, mode, operand) in code.items():
+        if opcode in store_opcodes and 0xd400 <= operand <= 0xd418:
+            patches[ofs] = operand & 0xff
+    return patches
+
+def find_indirect_sid_writes(code):
+    '''Find indirect stores which may write SID registers through a $d4xx pointer'''
+    # STA (zp,X), STA (zp),Y. a pointer to the sid needs an immediate $d4 high byte
+    store_opcodes = [ 0x81, 0x91 ]
+    load_opcodes = [ 0xa9, 0xa2, 0xa0 ]
+    if not any(opcode in load_opcodes and operand == 0xd4 for (opcode, mode, operand) in code.values()):
+        return []
+    return sorted(ofs for ofs, (opcode, mode, operand) in code.items() if opcode in store_opcodes)
+
+def find_zero_page_use(code):
+    '''Collect zero page addresses accessed by the traced code'''
+    zp = set()
+    for (opcode, mode, operand) in code.values():
+        if mode in (AddressMode.zp, AddressMode.zpx, AddressMode.zpy):
+            zp.add(operand)
+        elif mode in (AddressMode.izx, AddressMode.izy):
+            zp.add(operand)
+            zp.add((operand + 1) & 0xff)
+
+    # $00/$01 is the cpu port, not a zero page variable
+    zp.discard(0x00)
+    zp.discard(0x01)
+    return zp
+
+def sidc(sid_file, output_file, linker_file=None, shadow=False):
     '''Dump SID file information'''
     global sid, sid_ofs, sid_size
+    name = NAME
 
     sid = None
     sid_ofs = 0
@@ -90,8 +175,10 @@ def sidc(sid_file, output_file):
     version = show("version", 2, False, True)
     data_offset = show("data offset", 2, True, True)
     load_address = show("load address", 2, True, False)
+    data_start = data_offset
     if load_address == 0x0:
         load_address = int.from_bytes(sid[data_offset:data_offset + 2], 'little')
+        data_start = data_offset + 2
         print(f"encoded load address: ${load_address:04x}")
 
     init_address = show("init address", 2, True, False)
@@ -136,6 +223,33 @@ def sidc(sid_file, output_file):
 
     ###############################################
 
+    sid_music_data_size = sid_size - data_start
+
+    data = sid[data_start:sid_size]
+
+    # only instructions reached from init/play are inspected, data tables stay untouched
+    code = trace_code(data, load_address, [init_address, play_address])
+
+    patches = {}
+    if shadow:
+        indirect_writes = find_indirect_sid_writes(code)
+        if indirect_writes:
+            print("player may write the sid through a pointer, which can't be shadowed:")
+            for ofs in indirect_writes:
+                print(f"  ${load_address+ofs:04x}: ${data[ofs]:02x} ${data[ofs+1]:02x}")
+            sys.exit(4)
+
+        patches = find_sid_writes(code)
+        print(f"shadowed sid writes: {len(patches)}")
+        for ofs in sorted(patches):
+            print(f"  ${load_address+ofs:04x}: ${data[ofs]:02x} $d4{patches[ofs]:02x}")
+
+    zero_page = find_zero_page_use(code)
+    if zero_page:
+        print(f"zero page used: ${min(zero_page):02x}-${max(zero_page):02x}")
+    else:
+        print("zero page used: none")
+
     out_file = open(output_file, "w")
 
     out_file.write("// *****************************************************************************\n")
@@ -143,77 +257,89 @@ def sidc(sid_file, output_file):
     out_file.write("// Name: " + sid_name + "\n")
     out_file.write("// Author: " + sid_author + "\n")
     out_file.write("// (C) " + sid_released + "\n")
+    out_file.write("// @generated by sidc\n")
     out_file.write("// *****************************************************************************\n")
     out_file.write("\n")
 
+    out_file.write("#include <cstddef>\n")
     out_file.write("#include <cstdint>\n")
-
     out_file.write("\n")
-    #out_file.write('extern const uint8_t sid_data[] __attribute__ ((section (".sid"))) = {\n')
-    out_file.write('extern const uint8_t sid_data[] = {\n')
-
-    sid_music_data_size = sid_size - (data_offset+2)
-
-    line = "  "
-    for ofs in range(data_offset+2, sid_size):
-        b = sid[ofs]
-        line += format_byte(b)
-        if ofs < sid_size - 1: line += ","
-        if ofs == sid_size - 1 or len(line) >= MAX_LINE_LENGTH:
-            out_file.write(line)
-            out_file.write("\n")
-            line = "  "
-
-    out_file.write("};\n")
-    out_file.write("\n")
-    out_file.write("struct sid_info_t {\n")
-    out_file.write("  const uint16_t load_address;\n")
-    out_file.write("  const uint16_t init_address;\n")
-    out_file.write("  const uint16_t play_address;\n")
-    out_file.write("  const uint16_t num_songs;\n")
-    out_file.write("  const uint16_t start_song;\n")
-    out_file.write("  const uint32_t speed;\n")
-    out_file.write("  const uint16_t size;\n")
-    out_file.write("  const uint8_t* data;\n")
-    out_file.write("};\n")
+
+    out_file.write(f"extern const size_t {name}_size = 0x{sid_music_data_size:04x};\n")
+    out_file.write(f"extern const bool {name}_shadowed = {'true' if shadow else 'false'};\n")
     out_file.write("\n")
 
-    out_file.write("extern const sid_info_t sid_info {\n")
-    out_file.write(f"  0x{load_address:04x},                       // load address\n")
-    out_file.write(f"  0x{init_address:04x},                       // init address\n")
-    out_file.write(f"  0x{play_address:04x},                       // play address\n")
-    out_file.write(f"  0x{num_songs:04x},                       // song count\n")
-    out_file.write(f"  0x{start_song:02x},                         // start song\n")
-    out_file.write(f"  0x{speed:08x},                   // speed\n")
-    out_file.write(f"  0x{sid_music_data_size:04x},                       // size\n")
-    out_file.write(f"  (const uint8_t*) sid_data     // data\n")
-    out_file.write("};\n")
+    # sid data is placed at its load address by the linker (see linker fragment),
+    # so there is no need to copy it at runtime. patched sid register operands
+    # are emitted as relocations to the shadow register buffer.
+    out_file.write("asm (\n")
+    out_file.write(f"  \".section .{name},\\\"a\\\",@progbits\\n\"\n")
+    out_file.write(f"  \".global {name}\\n\"\n")
+    out_file.write(f"  \"{name}:\\n\"\n")
+
+    line = ""
+    ofs = 0
+    while ofs < len(data):
+        if ofs in patches:
+            if line:
+                out_file.write(f"  \"  .byte {line}\\n\"\n")
+                line = ""
+            out_file.write(f"  \"  .byte {format_byte(data[ofs])}\\n\"\n")
+            out_file.write(f"  \"  .word audio_sid_shadow+0x{patches[ofs]:02x}\\n\"\n")
+            ofs += 3
+            continue
+        if line: line += ","
+        line += format_byte(data[ofs])
+        ofs += 1
+        if len(line) >= MAX_LINE_LENGTH - 16 or ofs == len(data):
+            out_file.write(f"  \"  .byte {line}\\n\"\n")
+            line = ""
+    if line:
+        out_file.write(f"  \"  .byte {line}\\n\"\n")
+
+    out_file.write(");\n")
     out_file.write("\n")
 
+    # init/play addresses are link-time constants, no runtime patching needed
     out_file.write("asm (\n")
+    out_file.write(f"  \".global {name}_load_address\\n\"\n")
+    out_file.write(f"  \".set {name}_load_address, 0x{load_address:04x}\\n\"\n")
+    out_file.write(f"  \".global {name}_init_address\\n\"\n")
+    out_file.write(f"  \".set {name}_init_address, 0x{init_address:04x}\\n\"\n")
+    out_file.write(f"  \".global {name}_play_address\\n\"\n")
+    out_file.write(f"  \".set {name}_play_address, 0x{play_address:04x}\\n\"\n")
+    out_file.write("\n")
     out_file.write("  \".text\\n\"\n")
     out_file.write("  \".global init_audio\\n\"\n")
     out_file.write("  \"init_audio:\\n\"\n")
-    out_file.write("  \"  lda #0\\n\"\n")
+    out_file.write(f"  \"  lda #${max(start_song-1, 0):02x}\\n\"\n")
+    out_file.write("  \"  ldx #0\\n\"\n")
     out_file.write("  \"  ldy #0\\n\"\n")
-    out_file.write(f"  \"  ldx #${start_song:02x}\\n\"\n")
-    out_file.write(f"  \"  jsr ${init_address:04x}\\n\"\n")
-    out_file.write("  \"  rts\\n\"\n")
+    out_file.write(f"  \"  jmp {name}_init_address\\n\"\n")
+    out_file.write("\n")
     out_file.write("  \".global update_audio\\n\"\n")
     out_file.write("  \"update_audio:\\n\"\n")
-    out_file.write(f"  \"  jsr ${play_address:04x}\\n\"\n")
-    out_file.write("  \"  rts\\n\"\n")
+    out_file.write(f"  \"  jmp {name}_play_address\\n\"\n")
     out_file.write(");\n")
-    out_file.write("\n")
 
     out_file.close()
 
+    if linker_file:
+        with open(linker_file, "w") as ld_file:
+            ld_file.write(f"/* SID data '{sid_name}' placed at its load address. @generated by sidc */\n")
+            ld_file.write("SECTIONS {\n")
+            ld_file.write(f"    .{name} 0x{load_address:04x} : {{ KEEP(*(.{name})) }} >ram\n")
+            ld_file.write("}\n")
+            ld_file.write("\n")
+            ld_file.write("/* Lowest zero page address used by the player code (0x100: none). */\n")
+            ld_file.write(f"__{name}_zp = 0x{min(zero_page, default=0x100):02x};\n")
+
     return
 
 def main():
     '''Main entry'''
     try:
-        opts, args = getopt.getopt(sys.argv[1:], "h:", ["help"])
+        opts, args = getopt.getopt(sys.argv[1:], "hl:s", ["help", "linker=", "shadow"])
     except getopt.GetoptError:
         usage()
         sys.exit(2)
@@ -222,11 +348,16 @@ def main():
         usage()
         sys.exit()
 
-    output = "build"
+    linker_file = None
+    shadow = False
     for o, a in opts:
         if o in ("-h", "--help"):
             usage()
             sys.exit()
+        elif o in ("-l", "--linker"):
+            linker_file = Path(a)
+        elif o in ("-s", "--shadow"):
+            shadow = True
 
     source = Path(args[0])
     if not source.exists or not os.path.isfile(source):
@@ -236,7 +367,7 @@ def main():
     dest = None
     if len(args) >= 2 : dest = Path(args[1])
 
-    sidc(source, dest)
+    sidc(source, dest, linker_file, shadow)
 
 if __name__ == "__main__":
     main()
@@ -0,0 +1,13 @@
+@ECHO OFF
+
+REM #
+REM # size64 - Code and data size report for C64 programs
+REM # (C) Roland Schabenberger
+REM #
+
+SETLOCAL
+PUSHD %~dp0
+SET SCRIPT_DIR=%CD%
+POPD
+python %SCRIPT_DIR%\size64.py %1 %2 %3 %4 %5 %6 %7 %8
+ENDLOCAL
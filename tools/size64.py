@@ -0,0 +1,338 @@
+#
+# size64 - Code and data size report for C64 programs
+# (C) Roland Schabenberger
+#
+
+import sys
+import os
+import os.path
+import getopt
+import json
+from pathlib import Path
+
+from bench64 import read_elf_sections, read_elf_symbols
+from dis64 import demangle
+
+SHT_NOBITS = 8
+SHF_EXECINSTR = 0x4
+STT_OBJECT = 1
+STT_FUNC = 2
+STT_FILE = 4
+SHN_LORESERVE = 0xff00
+
+DEFAULT_TOP = 30
+DEFAULT_WINDOW = 12
+
+class Symbol:
+    def __init__(self, name, address, size, kind, section):
+        self.name = name
+        self.address = address
+        self.size = size
+        self.kind = kind            # code, data or bss
+        self.section = section
+        self.module = "-"
+        self.data = b""
+        self.is_function = False
+
+def usage():
+    print("Usage: size64 [-m MAP] [-b BASELINE] [-u] [-n COUNT] [-w BYTES] ELF")
+    print("")
+    print("ELF               : Linked program with symbols (build/*.prg.elf)")
+    print("-m, --map         : Linker map for module names (default: ELF name with .map)")
+    print("-b, --baseline    : Compare with baseline (.json)")
+    print("-u, --update      : Write current sizes to the baseline")
+    print("-n, --top         : Number of listed symbols (default: 30)")
+    print("-w, --window      : Minimum length of shared code sequences (default: 12)")
+    print("-h, --help        : Show this help")
+
+def default_map_file(elf_file):
+    name = Path(elf_file).name
+    for suffix in (".elf", ".prg"):
+        if name.endswith(suffix): name = name[:-len(suffix)]
+    return Path(elf_file).parent / (name + ".map")
+
+def module_name(path):
+    '''build/libcpp64/src/video.cpp.o -> video.cpp, libc.a(printf.c.obj) -> libc.a(printf.c)'''
+    name = path.replace("\\", "/").split("/")[-1]
+    for suffix in (".obj", ".o"):
+        if name.endswith(suffix): name = name[:-len(suffix)]
+        elif name.endswith(suffix + ")"): name = name[:-len(suffix) - 1] + ")"
+    return name
+
+def load_map(filename):
+    '''Read input sections (output section, address, size, module) from an
+    lld linker map (VMA LMA Size Align Out In Symbol)'''
+    input_sections = []
+    column = None
+    output_section = None
+    with open(filename, "r") as in_file:
+        for line in in_file:
+            if column is None:
+                if "VMA" in line and "Out" in line: column = line.index("Out")
+                continue
+            fields = line[:column].split()
+            if len(fields) != 4: continue
+            rest = line[column:].rstrip("\n")
+            depth = len(rest) - len(rest.lstrip(" "))
+            text = rest.strip()
+            try:
+                address = int(fields[0], 16) & 0xffff
+                size = int(fields[2], 16)
+            except ValueError:
+                continue
+            if depth == 0:
+                output_section = text
+            elif depth <= 8 and ":(" in text and size > 0:
+                input_sections.append((output_section, address, size, module_name(text[:text.rindex(":(")])))
+    return input_sections
+
+def load_program(elf_file, map_file):
+    with open(elf_file, "rb") as in_file:
+        data = in_file.read()
+    if data[:4] != b"\x7fELF":
+        raise RuntimeError(f"{elf_file} is not an ELF file")
+
+    sections = read_elf_sections(data)
+    input_sections = load_map(map_file) if map_file else []
+
+    symbols = []
+    file_module = "-"
+    seen = set()
+    for name, value, size, type, shndx in read_elf_symbols(data):
+        if type == STT_FILE:
+            file_module = module_name(name)
+            continue
+        if size == 0 or shndx == 0 or shndx >= SHN_LORESERVE: continue
+        if type not in (STT_OBJECT, STT_FUNC): continue
+        if (name, value) in seen: continue
+        seen.add((name, value))
+
+        section_name, section_type, flags, address, offset, section_size = sections[shndx]
+        if section_type == SHT_NOBITS: kind = "bss"
+        elif flags & SHF_EXECINSTR: kind = "code"
+        else: kind = "data"
+
+        symbol = Symbol(name, value, size, kind, section_name)
+        symbol.is_function = type == STT_FUNC
+        symbol.module = file_module
+        if section_type != SHT_NOBITS:
+            start = offset + value - (address & 0xffff)
+            symbol.data = data[start:start + size]
+
+        for output_section, start, length, module in input_sections:
+            if output_section == section_name and start <= value < start + length:
+                symbol.module = module
+                break
+        symbols.append(symbol)
+
+    # section contents for reference search
+    contents = []
+    for section_name, section_type, flags, address, offset, section_size in sections:
+        if section_type == SHT_NOBITS or address == 0: continue
+        contents.append(data[offset:offset + section_size])
+
+    entry = int.from_bytes(data[0x18:0x1c], "little") & 0xffff
+    return symbols, contents, entry
+
+def is_referenced(symbol, contents):
+    '''absolute address (jsr, jmp, pointer tables) or a lo/hi pair of
+    immediate loads (function pointers in llvm-mos code)'''
+    lo = symbol.address & 0xff
+    hi = (symbol.address >> 8) & 0xff
+    word = bytes((lo, hi))
+    for data in contents:
+        if word in data: return True
+        pos = 0
+        while True:
+            pos = data.find(bytes((lo,)), pos + 1)
+            if pos < 1: break
+            if data[pos - 1] not in (0xa9, 0xa2, 0xa0): continue     # lda/ldx/ldy #
+            window = data[pos + 1:pos + 10]
+            for i in range(len(window) - 1):
+                if window[i] in (0xa9, 0xa2, 0xa0) and window[i + 1] == hi: return True
+    return False
+
+def find_unreferenced(symbols, contents, entry):
+    unreferenced = []
+    for symbol in symbols:
+        if not symbol.is_function or symbol.address == entry: continue
+        if symbol.name.startswith("__") or symbol.name in ("_start", "main"): continue
+        if not is_referenced(symbol, contents):
+            unreferenced.append(symbol)
+    return unreferenced
+
+def find_identical(symbols):
+    groups = {}
+    for symbol in symbols:
+        if symbol.kind == "bss" or symbol.size < 4: continue
+        groups.setdefault(symbol.data, []).append(symbol)
+    return [group for group in groups.values() if len(group) > 1]
+
+def find_shared(symbols, window):
+    '''byte sequences of at least window bytes occurring in more than one
+    function, e.g. inlined helpers: {(first, other): shared bytes}'''
+    first = {}
+    shared = {}
+    for symbol in symbols:
+        if symbol.kind != "code" or symbol.size < window: continue
+        marks = {}
+        for i in range(symbol.size - window + 1):
+            sequence = symbol.data[i:i + window]
+            owner = first.setdefault(sequence, symbol)
+            if owner is symbol: continue
+            covered = marks.setdefault(owner, set())
+            covered.update(range(i, i + window))
+        for owner, covered in marks.items():
+            shared[(owner, symbol)] = len(covered)
+    return shared
+
+def format_delta(current, reference):
+    if reference is None: return "new"
+    delta = current - reference
+    return f"{delta:+d}" if delta else "0"
+
+def report(elf_file, map_file, baseline_file, update, top, window):
+
+    if map_file is None:
+        candidate = default_map_file(elf_file)
+        if candidate.exists(): map_file = candidate
+
+    symbols, contents, entry = load_program(elf_file, map_file)
+    names = demangle([symbol.name for symbol in symbols])
+    def readable(symbol): return names.get(symbol.name, symbol.name)
+
+    baseline = {}
+    if baseline_file and Path(baseline_file).exists():
+        with open(baseline_file, "r") as in_file:
+            baseline = json.load(in_file)
+    elif baseline_file and not update:
+        print(f"no baseline {baseline_file} yet, create it with -u")
+        print("")
+    base_totals = baseline.get("totals", {})
+    base_modules = baseline.get("modules", {})
+    base_symbols = baseline.get("symbols", {})
+
+    totals = { "code": 0, "data": 0, "bss": 0 }
+    modules = {}
+    for symbol in symbols:
+        totals[symbol.kind] += symbol.size
+        module = modules.setdefault(symbol.module, { "code": 0, "data": 0, "bss": 0 })
+        module[symbol.kind] += symbol.size
+
+    print(f"program: {elf_file}")
+    print(f"map: {map_file or '-'}")
+    print("")
+    print(f"{'':<32} {'code':>8} {'data':>8} {'bss':>8} {'total':>8} {'delta':>8}")
+    total = sum(totals.values())
+    print(f"{'total':<32} {totals['code']:>8} {totals['data']:>8} {totals['bss']:>8} {total:>8} {format_delta(total, base_totals.get('total')):>8}")
+    print("")
+
+    print(f"{'module':<32} {'code':>8} {'data':>8} {'bss':>8} {'total':>8} {'delta':>8}")
+    module_totals = {}
+    for name, sizes in sorted(modules.items(), key=lambda item: -sum(item[1].values())):
+        module_total = sum(sizes.values())
+        module_totals[name] = module_total
+        print(f"{name:<32} {sizes['code']:>8} {sizes['data']:>8} {sizes['bss']:>8} {module_total:>8} {format_delta(module_total, base_modules.get(name)):>8}")
+    for name in sorted(set(base_modules) - set(modules)):
+        print(f"{name:<32} {'-':>8} {'-':>8} {'-':>8} {'-':>8} {-base_modules[name]:>+8}")
+    print("")
+
+    print(f"{'size':>6} {'kind':<5} {'address':<8} {'module':<20} symbol")
+    for symbol in sorted(symbols, key=lambda s: (-s.size, s.address))[:top]:
+        print(f"{symbol.size:>6} {symbol.kind:<5} ${symbol.address:04x}    {symbol.module:<20} {readable(symbol)}")
+    print("")
+
+    if baseline:
+        current = {}
+        for symbol in symbols: current[symbol.name] = current.get(symbol.name, 0) + symbol.size
+        changes = []
+        for name in set(current) | set(base_symbols):
+            delta = current.get(name, 0) - base_symbols.get(name, 0)
+            if delta: changes.append((delta, name))
+        print(f"changes since baseline: {len(changes)}")
+        for delta, name in sorted(changes, key=lambda c: (-abs(c[0]), c[1])):
+            state = "new" if name not in base_symbols else ("removed" if name not in current else "")
+            print(f"{delta:>+6} {state:<8} {names.get(name, name)}")
+        print("")
+
+    unreferenced = find_unreferenced(symbols, contents, entry)
+    if unreferenced:
+        print(f"functions without a reference (dead code?): {sum(s.size for s in unreferenced)} bytes")
+        for symbol in sorted(unreferenced, key=lambda s: -s.size):
+            print(f"{symbol.size:>6}       ${symbol.address:04x}    {symbol.module:<20} {readable(symbol)}")
+        print("")
+
+    identical = find_identical(symbols)
+    if identical:
+        print("identical symbols")
+        for group in identical:
+            print(f"{group[0].size:>6} x{len(group):<4} " + ", ".join(readable(s) for s in group))
+        print("")
+
+    shared = find_shared(symbols, window)
+    if shared:
+        print(f"code shared between functions (sequences of {window}+ bytes, inlined or duplicated)")
+        for (owner, other), size in sorted(shared.items(), key=lambda item: -item[1])[:top]:
+            print(f"{size:>6}  {readable(other)}  <->  {readable(owner)}")
+        print("")
+
+    if update and baseline_file:
+        result = {
+            "totals": { "code": totals["code"], "data": totals["data"], "bss": totals["bss"], "total": total },
+            "modules": module_totals,
+            "symbols": {}
+        }
+        for symbol in symbols:
+            result["symbols"][symbol.name] = result["symbols"].get(symbol.name, 0) + symbol.size
+        Path(baseline_file).parent.mkdir(parents=True, exist_ok=True)
+        with open(baseline_file, "w") as out_file:
+            json.dump(result, out_file, indent=4, sort_keys=True)
+            out_file.write("\n")
+        print(f"baseline written to {baseline_file}")
+
+def main():
+    '''Main entry'''
+    try:
+        opts, args = getopt.getopt(sys.argv[1:], "hm:b:un:w:", ["help", "map=", "baseline=", "update", "top=", "window="])
+    except getopt.GetoptError:
+        usage()
+        sys.exit(2)
+
+    if len(args) < 1:
+        usage()
+        sys.exit()
+
+    map_file = None
+    baseline_file = None
+    update = False
+    top = DEFAULT_TOP
+    window = DEFAULT_WINDOW
+
+    for o, a in opts:
+        if o in ("-h", "--help"):
+            usage()
+            sys.exit()
+        elif o in ("-m", "--map"):
+            map_file = a
+        elif o in ("-b", "--baseline"):
+            baseline_file = a
+        elif o in ("-u", "--update"):
+            update = True
+        elif o in ("-n", "--top"):
+            top = int(a)
+        elif o in ("-w", "--window"):
+            window = max(int(a), 2)
+
+    elf_file = Path(args[0])
+    if not elf_file.exists() or not os.path.isfile(elf_file):
+        print(f"{elf_file} does not exist or is invalid")
+        sys.exit(3)
+
+    try:
+        report(elf_file, map_file, baseline_file, update, top, window)
+    except (RuntimeError, OSError) as err:
+        print(f"error: {err}")
+        sys.exit(1)
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,241 @@
+#
+# sprite64 - Sprite bank importer for SpritePad files
+# (C) Roland Schabenberger
+#
+
+import sys
+import os
+import os.path
+import getopt
+import json
+from pathlib import Path
+
+from pack64 import read_spd_sprites, compress, format_byte, MAX_LINE_LENGTH
+
+SPRITE_SIZE = 64
+SPRITE_DATA_SIZE = 63           # byte 63 holds the SpritePad color/mode attribute
+SPRITE_BYTES_PER_ROW = 3
+SPRITE_ROWS = 21
+MULTICOLOR_FLAG = 0x80
+
+def usage():
+    print("Usage: sprite64 [-a ANIMATIONS] [-z] [-n NAME] [-H HEADER] INFILE OUTFILE")
+    print("")
+    print("INFILE            : SpritePad .spd file")
+    print("OUTFILE           : C++ source file with the sprite bank")
+    print("-a, --animations  : Animations (.json, {\"animations\": {\"walk\": [0, 1, 2], ...}})")
+    print("-z, --pack        : LZ4 pack the bank (for Video::loadSprites(packed))")
+    print("-n, --name        : Symbol name (default: sprite_bank)")
+    print("-H, --header      : Header file with frame indices (default: OUTFILE with .h)")
+    print("")
+    print("An animation can also be {\"frames\": [0, 1, 2], \"mirror\": true} to use horizontally")
+    print("mirrored copies of the frames. Without animations, all frames are kept.")
+
+def mirror_byte(value, multicolor):
+    result = 0
+    if multicolor:
+        for i in range(4):
+            result = (result << 2) | ((value >> (i * 2)) & 0x03)
+    else:
+        for i in range(8):
+            result = (result << 1) | ((value >> i) & 0x01)
+    return result
+
+def mirror_sprite(sprite):
+    '''flip a sprite horizontally, bit pairs are kept in multi-color mode'''
+    multicolor = (sprite[SPRITE_DATA_SIZE] & MULTICOLOR_FLAG) != 0
+    mirrored = bytearray(sprite)
+    for row in range(SPRITE_ROWS):
+        ofs = row * SPRITE_BYTES_PER_ROW
+        for i in range(SPRITE_BYTES_PER_ROW):
+            mirrored[ofs + i] = mirror_byte(sprite[ofs + SPRITE_BYTES_PER_ROW - 1 - i], multicolor)
+    return bytes(mirrored)
+
+def read_animations(filename, frame_count):
+    '''list of (name, [(frame, mirrored), ...])'''
+    with open(filename, "r") as in_file:
+        config = json.load(in_file)
+
+    animations = []
+    for name, entry in config.get("animations", {}).items():
+        mirrored = False
+        frames = entry
+        if isinstance(entry, dict):
+            frames = entry.get("frames", [])
+            mirrored = entry.get("mirror", False)
+        for frame in frames:
+            if frame < 0 or frame >= frame_count:
+                raise ValueError(f"animation '{name}': frame {frame} out of range (0..{frame_count - 1})")
+        animations.append((name, [(frame, mirrored) for frame in frames]))
+    return animations
+
+class SpriteBank:
+    def __init__(self):
+        self.sprites = []
+        self.lookup = {}
+
+    def add(self, sprite):
+        '''index of the sprite in the bank, identical sprites are stored once'''
+        key = sprite[0:SPRITE_DATA_SIZE]
+        index = self.lookup.get(key)
+        if index != None: return index
+        index = len(self.sprites)
+        self.sprites.append(sprite)
+        self.lookup[key] = index
+        return index
+
+    def data(self):
+        return b"".join(self.sprites)
+
+def build_bank(sprites, animations):
+    '''bank and list of (name, [bank index, ...]), sprites in order of first use'''
+    bank = SpriteBank()
+    mirrored_sprites = {}
+    tables = []
+    for name, frames in animations:
+        indices = []
+        for frame, mirrored in frames:
+            sprite = sprites[frame]
+            if mirrored:
+                if frame not in mirrored_sprites: mirrored_sprites[frame] = mirror_sprite(sprite)
+                sprite = mirrored_sprites[frame]
+            indices.append(bank.add(sprite))
+        tables.append((name, indices))
+    return bank, tables
+
+def write_bytes(out_file, data):
+    line = "  "
+    for i in range(len(data)):
+        line += format_byte(data[i])
+        if i < len(data) - 1: line += ","
+        if i == len(data) - 1 or len(line) >= MAX_LINE_LENGTH:
+            out_file.write(line + "\n")
+            line = "  "
+
+def write_cpp(filename, name, source, data):
+    with open(filename, "w") as out_file:
+        out_file.write("// *****************************************************************************\n")
+        out_file.write(f"// Sprite bank: {source}\n")
+        out_file.write("// @generated by sprite64\n")
+        out_file.write("// *****************************************************************************\n")
+        out_file.write("\n")
+        out_file.write("#include <cstddef>\n")
+        out_file.write("#include <cstdint>\n")
+        out_file.write("\n")
+        out_file.write(f"extern const uint8_t {name}[] = {{\n")
+        write_bytes(out_file, data)
+        out_file.write("};\n")
+        out_file.write("\n")
+        out_file.write(f"extern const size_t {name}_size = {len(data)};\n")
+
+def write_header(filename, name, source, frame_count, tables, packed):
+    with open(filename, "w") as out_file:
+        out_file.write("// *****************************************************************************\n")
+        out_file.write(f"// Sprite bank: {source}\n")
+        out_file.write("// @generated by sprite64\n")
+        out_file.write("// *****************************************************************************\n")
+        out_file.write("\n")
+        out_file.write("#pragma once\n")
+        out_file.write("\n")
+        out_file.write("#include <cstddef>\n")
+        out_file.write("#include <cstdint>\n")
+        out_file.write("\n")
+        if packed:
+            out_file.write(f"extern const uint8_t {name}[];          // packed, see Video::loadSprites(packed)\n")
+        else:
+            out_file.write(f"extern const uint8_t {name}[];\n")
+        out_file.write(f"extern const size_t {name}_size;\n")
+        out_file.write("\n")
+        out_file.write(f"const uint8_t {name}_frame_count = {frame_count};\n")
+        out_file.write("\n")
+        out_file.write("// sprite blocks relative to the first block of the bank (constexpr, can be checked with static_assert)\n")
+        for table_name, indices in tables:
+            out_file.write(f"constexpr uint8_t {name}_{table_name}[] = {{ {', '.join(str(index) for index in indices)} }};\n")
+            out_file.write(f"const uint8_t {name}_{table_name}_length = {len(indices)};\n")
+
+def import_sprites(input_file, output_file, animations_file=None, packed=False, name=None, header_file=None):
+
+    with open(input_file, "rb") as in_file:
+        sprites_data = read_spd_sprites(in_file.read())
+
+    sprites = [sprites_data[i:i+SPRITE_SIZE] for i in range(0, len(sprites_data), SPRITE_SIZE)]
+
+    if animations_file:
+        try:
+            animations = read_animations(animations_file, len(sprites))
+        except ValueError as e:
+            print(f"{animations_file}: {e}")
+            sys.exit(1)
+    else:
+        animations = [("frames", [(frame, False) for frame in range(len(sprites))])]
+
+    bank, tables = build_bank(sprites, animations)
+    data = bank.data()
+
+    used = set(entry for _, frames in animations for entry in frames)
+    referenced = set(frame for frame, _ in used)
+    mirrored = set(frame for frame, mirrored in used if mirrored)
+
+    print(f"input: {input_file} ({len(sprites)} sprites, {len(sprites_data)} bytes)")
+    print(f"unused: {len(sprites) - len(referenced)} sprites, mirrored: {len(mirrored)} sprites, duplicates: {len(used) - len(bank.sprites)} sprites")
+    print(f"bank: {len(bank.sprites)} sprites, {len(data)} bytes")
+
+    if packed:
+        block, _ = compress(data)
+        packed_data = bytearray()
+        packed_data.append(len(data) & 0xff)
+        packed_data.append(len(data) >> 8)
+        packed_data.extend(block)
+        print(f"packed size: {len(packed_data)} bytes ({100.0 * len(packed_data) / max(len(data), 1):.1f}%)")
+        data = packed_data
+
+    if not output_file: return
+
+    if not name: name = "sprite_bank"
+    if not header_file: header_file = Path(output_file).with_suffix(".h")
+
+    write_cpp(output_file, name, Path(input_file).name, data)
+    write_header(header_file, name, Path(input_file).name, len(bank.sprites), tables, packed)
+
+def main():
+    '''Main entry'''
+    try:
+        opts, args = getopt.getopt(sys.argv[1:], "ha:zn:H:", ["help", "animations=", "pack", "name=", "header="])
+    except getopt.GetoptError:
+        usage()
+        sys.exit(2)
+
+    if len(args) < 1:
+        usage()
+        sys.exit()
+
+    animations = None
+    packed = False
+    name = None
+    header = None
+
+    for o, a in opts:
+        if o in ("-h", "--help"):
+            usage()
+            sys.exit()
+        elif o in ("-a", "--animations"):
+            animations = a
+        elif o in ("-z", "--pack"):
+            packed = True
+        elif o in ("-n", "--name"):
+            name = a
+        elif o in ("-H", "--header"):
+            header = a
+
+    source = Path(args[0])
+    if not source.exists() or not os.path.isfile(source):
+        print(f"{source} does not exist or is invalid")
+        sys.exit(3)
+
+    dest = None
+    if len(args) >= 2: dest = Path(args[1])
+
+    import_sprites(source, dest, animations, packed, name, header)
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,13 @@
+@ECHO OFF
+
+REM #
+REM # trace64 - Timeline decoder for libcpp64 trace events
+REM # (C) Roland Schabenberger
+REM #
+
+SETLOCAL
+PUSHD %~dp0
+SET SCRIPT_DIR=%CD%
+POPD
+python %SCRIPT_DIR%\trace64.py %1 %2 %3 %4 %5 %6 %7 %8
+ENDLOCAL
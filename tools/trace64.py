@@ -0,0 +1,198 @@
+#
+# trace64 - Timeline decoder for libcpp64 trace events
+# (C) Roland Schabenberger
+#
+
+import sys
+import os
+import os.path
+import getopt
+import json
+import re
+from pathlib import Path
+
+VALUE_HI_PORT = 0xd7fc
+VALUE_LO_PORT = 0xd7fd
+EVENT_PORT = 0xd7fe
+
+RASTER_LINES = 312
+CYCLES_PER_LINE = 63
+
+# libcpp64/trace.h
+LIBRARY_EVENTS = {
+    0xf0: "irq_begin",
+    0xf1: "irq_end",
+    0xf2: "wait_begin",
+    0xf3: "wait_end",
+    0xf4: "load_begin",
+    0xf5: "load_end"
+}
+
+MONITOR_COMMANDS = "tr store d7fc d7fe\n"
+
+RE_CHECKPOINT = re.compile(r"^#\d+ \(Trace\s+store[^)]*\)\s+(\d+)(?:/\$[0-9a-fA-F]+)?,?\s+(\d+)")
+RE_STORE = re.compile(r"\bST([AXY])\s+\$([0-9a-fA-F]{4})\b.*\bA:([0-9a-fA-F]{2})\s+X:([0-9a-fA-F]{2})\s+Y:([0-9a-fA-F]{2})")
+
+class Event:
+    def __init__(self, frame, line, cycle, id, value):
+        self.frame = frame
+        self.line = line
+        self.cycle = cycle
+        self.id = id
+        self.value = value
+
+    def time(self):
+        return (self.frame * RASTER_LINES + self.line) * CYCLES_PER_LINE + self.cycle
+
+def usage():
+    print("Usage: trace64 [-r] [-n NAMES] [-s] [--ntsc] LOGFILE")
+    print("       trace64 -c")
+    print("")
+    print("LOGFILE           : VICE monitor log, or raw writes with -r")
+    print("-c, --commands    : Print the VICE monitor commands to log the trace ports")
+    print("-r, --raw         : Input lines are 'line cycle address value' (hex address and value)")
+    print("-n, --names       : Event names (.json, {\"1\": \"level_start\", ...})")
+    print("-s, --summary     : Print durations of begin/end pairs only")
+    print("    --ntsc        : 263 raster lines of 65 cycles")
+    print("-h, --help        : Show this help")
+
+def read_vice_log(filename):
+    '''(line, cycle, address, value) of the logged stores'''
+    writes = []
+    position = None
+    with open(filename, "r", errors="replace") as in_file:
+        for text in in_file:
+            match = RE_CHECKPOINT.match(text.strip())
+            if match:
+                position = (int(match.group(1)), int(match.group(2)))
+                continue
+            match = RE_STORE.search(text)
+            if match and position != None:
+                register = "AXY".index(match.group(1).upper())
+                writes.append((position[0], position[1], int(match.group(2), 16), int(match.group(3 + register), 16)))
+                position = None
+    return writes
+
+def read_raw_log(filename):
+    writes = []
+    with open(filename, "r") as in_file:
+        for text in in_file:
+            fields = text.split("#")[0].split()
+            if len(fields) < 4: continue
+            writes.append((int(fields[0]), int(fields[1]), int(fields[2], 16), int(fields[3], 16)))
+    return writes
+
+def decode(writes):
+    '''value ports are latched until the next event write, a raster line
+    lower than the previous one starts a new frame'''
+    events = []
+    frame = 0
+    last_line = -1
+    value_lo = None
+    value_hi = None
+    for line, cycle, address, value in writes:
+        if line < last_line: frame += 1
+        last_line = line
+        if address == VALUE_LO_PORT:
+            value_lo = value
+        elif address == VALUE_HI_PORT:
+            value_hi = value
+        elif address == EVENT_PORT:
+            event_value = None
+            if value_lo != None: event_value = value_lo | ((value_hi or 0) << 8)
+            events.append(Event(frame, line, cycle, value, event_value))
+            value_lo = value_hi = None
+    return events
+
+def load_names(filename):
+    names = dict(LIBRARY_EVENTS)
+    if filename:
+        with open(filename, "r") as in_file:
+            for key, name in json.load(in_file).items():
+                names[int(key, 0)] = name
+    return names
+
+def event_name(names, id):
+    return names.get(id, f"event_{id:02x}")
+
+def print_timeline(events, names):
+    print(f"{'frame':>6} {'line':>5} {'cycle':>5} {'+lines':>7}  {'event':<20} value")
+    previous = None
+    for event in events:
+        delta = ""
+        if previous != None:
+            delta = f"{(event.time() - previous.time()) / CYCLES_PER_LINE:.1f}"
+        value = "" if event.value == None else f"{event.value} (${event.value:x})"
+        print(f"{event.frame:>6} {event.line:>5} {event.cycle:>5} {delta:>7}  {event_name(names, event.id):<20} {value}")
+        previous = event
+
+def print_summary(events, names):
+    '''durations of xxx_begin/xxx_end pairs in raster lines'''
+    open_events = {}
+    durations = {}
+    for event in events:
+        name = event_name(names, event.id)
+        if name.endswith("_begin"):
+            open_events[name[:-6]] = event
+        elif name.endswith("_end") and name[:-4] in open_events:
+            begin = open_events.pop(name[:-4])
+            durations.setdefault(name[:-4], []).append((event.time() - begin.time()) / CYCLES_PER_LINE)
+
+    frames = (events[-1].frame + 1) if events else 0
+    print(f"frames: {frames}, events: {len(events)}")
+    print("")
+    print(f"{'span':<20} {'count':>6} {'min':>8} {'avg':>8} {'max':>8}  (raster lines)")
+    for name, values in sorted(durations.items()):
+        print(f"{name:<20} {len(values):>6} {min(values):>8.1f} {sum(values) / len(values):>8.1f} {max(values):>8.1f}")
+
+def main():
+    '''Main entry'''
+    global RASTER_LINES, CYCLES_PER_LINE
+
+    try:
+        opts, args = getopt.getopt(sys.argv[1:], "hcrn:s", ["help", "commands", "raw", "names=", "summary", "ntsc"])
+    except getopt.GetoptError:
+        usage()
+        sys.exit(2)
+
+    raw = False
+    names_file = None
+    summary = False
+
+    for o, a in opts:
+        if o in ("-h", "--help"):
+            usage()
+            sys.exit()
+        elif o in ("-c", "--commands"):
+            print(MONITOR_COMMANDS, end="")
+            sys.exit()
+        elif o in ("-r", "--raw"):
+            raw = True
+        elif o in ("-n", "--names"):
+            names_file = a
+        elif o in ("-s", "--summary"):
+            summary = True
+        elif o == "--ntsc":
+            RASTER_LINES = 263
+            CYCLES_PER_LINE = 65
+
+    if len(args) < 1:
+        usage()
+        sys.exit()
+
+    log_file = Path(args[0])
+    if not log_file.exists() or not os.path.isfile(log_file):
+        print(f"{log_file} does not exist or is invalid")
+        sys.exit(3)
+
+    writes = read_raw_log(log_file) if raw else read_vice_log(log_file)
+    events = decode(writes)
+    names = load_names(names_file)
+
+    if summary:
+        print_summary(events, names)
+    else:
+        print_timeline(events, names)
+
+if __name__ == "__main__":
+    main()
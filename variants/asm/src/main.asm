@@ -5,9 +5,9 @@
 ; VIC configured to bank 3 ($c000..$ffff)
 ; 8 animated sprites
 ;
-; Sample playback:  4kHz, 8 bit
+; Sample playback:  6kHz, 8 bit
 ;                   312 raster lines, 50 fps
-;                   160 samples/frame,  2 lines/sample
+;                   125 samples/frame,  2.5 lines/sample
 ;
 
 !src "lib64/libmacro64.asm"